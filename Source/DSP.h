@@ -11,6 +11,7 @@
 #pragma once
 
 #include <cmath>
+#include <algorithm>
 
 inline void panningEqualPower(float panning, float& left, float& right)
 {
@@ -18,3 +19,139 @@ inline void panningEqualPower(float panning, float& left, float& right)
     left = std::cos(x);
     right = std::sin(x);
 }
+
+// Renders the next numSamples outputs of the one-pole smoother
+// state += (target - state) * coeff in closed form:
+// state_n = target + (state_0 - target) * (1 - coeff)^n
+// Four lanes each keep their own power and step it by (1 - coeff)^4, so no
+// sample waits on the one before it and the loop vectorizes.
+inline void onePoleRamp(float* dest, int numSamples, float& state, float target, float coeff) noexcept
+{
+    float delta = state - target;
+    
+    if (std::abs(delta) < 1e-6f) {  // settled
+        state = target;
+        for (int n = 0; n < numSamples; ++n) {
+            dest[n] = target;
+        }
+        return;
+    }
+    
+    float pole = 1.0f - coeff;
+    float power[4] = { pole, pole * pole, pole * pole * pole, pole * pole * pole * pole };
+    float step = power[3];
+    
+    int n = 0;
+    for (; n + 4 <= numSamples; n += 4) {
+        for (int lane = 0; lane < 4; ++lane) {
+            dest[n + lane] = target + delta * power[lane];
+            power[lane] *= step;
+        }
+    }
+    for (int lane = 0; n < numSamples; ++n, ++lane) {
+        dest[n] = target + delta * power[lane];
+    }
+    
+    if (numSamples > 0) {
+        state = dest[numSamples - 1];
+    }
+}
+
+// Tape-style soft clipper for the feedback loop with first-order
+// antiderivative anti-aliasing (ADAA). The curve is x - x^3 / (3 k^2),
+// clipped at |x| = k, so it has unity slope for small signals and
+// saturates at 1. Its antiderivative is a polynomial, which keeps ADAA cheap.
+// Both channels are processed together with branch-free math so the compiler
+// can keep them in the lanes of one SIMD register.
+// At 0 % drive the clipper is faded out, so patches without drive sound as
+// they did before it existed. A limiter that leaves everything up to 0 dBFS
+// alone stays in the loop at every drive setting and holds a runaway loop
+// at +6 dBFS.
+class Saturator
+{
+public:
+    void reset() noexcept
+    {
+        for (int ch = 0; ch < 2; ++ch) {
+            prevX[ch] = 0.0f;
+            prevAD[ch] = 0.0f;
+        }
+    }
+    
+    // Gain applied before the curve, half of it in dB is taken off again
+    // after: quiet repeats come up by that half and the ceiling comes down
+    // by it, so more drive means denser repeats rather than quieter ones.
+    // The clipper fades in over the first dB of drive.
+    void setDrive(float driveGain) noexcept
+    {
+        drive = driveGain;
+        makeup = 1.0f / std::sqrt(driveGain);
+        amount = std::clamp((driveGain - 1.0f) / (fadeInGain - 1.0f), 0.0f, 1.0f);
+    }
+    
+    void process(float& left, float& right) noexcept
+    {
+        // The state keeps running while faded out, so fading in doesn't click
+        float x[2] = { left * drive, right * drive };
+        float y[2];
+        
+        for (int ch = 0; ch < 2; ++ch) {
+            float ad = antiderivative(x[ch]);
+            float dx = x[ch] - prevX[ch];
+            bool tooClose = std::abs(dx) < 1e-5f;
+            
+            // When successive inputs are nearly equal the difference quotient
+            // is ill-conditioned, so use the curve at the midpoint instead.
+            float quotient = (ad - prevAD[ch]) / (tooClose ? 1.0f : dx);
+            float midpoint = clip((x[ch] + prevX[ch]) * 0.5f);
+            y[ch] = tooClose ? midpoint : quotient;
+            
+            prevX[ch] = x[ch];
+            prevAD[ch] = ad;
+        }
+        
+        left += amount * (y[0] * makeup - left);
+        right += amount * (y[1] * makeup - right);
+        
+        left = limit(left);
+        right = limit(right);
+    }
+    
+    // Unity up to limitThreshold, then a parabola that flattens out at
+    // limitCeiling with a continuous slope
+    static float limit(float x) noexcept
+    {
+        constexpr float width = limitCeiling - limitThreshold;
+        float a = std::abs(x);
+        float over = std::clamp(a - limitThreshold, 0.0f, 2.0f * width);
+        return std::copysign(std::min(a, limitThreshold + 2.0f * width) - over * over * (0.25f / width), x);
+    }
+    
+    static float clip(float x) noexcept
+    {
+        float xc = std::clamp(x, -knee, knee);
+        return xc - xc * xc * xc * cubic;
+    }
+    
+    static float antiderivative(float x) noexcept
+    {
+        // Past the knee the curve is flat at +/-1, so the antiderivative
+        // continues as a straight line with slope 1 in |x|.
+        float xc = std::clamp(x, -knee, knee);
+        float x2 = xc * xc;
+        return x2 * 0.5f - x2 * x2 * cubic * 0.25f + (std::abs(x) - std::abs(xc));
+    }
+    
+private:
+    static constexpr float knee = 1.5f;
+    static constexpr float cubic = 1.0f / (3.0f * knee * knee);
+    static constexpr float fadeInGain = 1.122f;     // +1 dB
+    static constexpr float limitThreshold = 1.0f;
+    static constexpr float limitCeiling = 2.0f;     // +6 dBFS
+    
+    float drive = 1.0f;
+    float makeup = 1.0f;
+    float amount = 0.0f;
+    float prevX[2] = { 0.0f, 0.0f };
+    float prevAD[2] = { 0.0f, 0.0f };
+};
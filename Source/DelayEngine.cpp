@@ -0,0 +1,411 @@
+/*
+  ==============================================================================
+
+    DelayEngine.cpp
+    Created: 31 Oct 2026 10:04:27am
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#include "DelayEngine.h"
+
+DelayEngine::FeedbackPath::FeedbackPath()
+{
+    lowCutFilter.setType(juce::dsp::StateVariableTPTFilterType::highpass);
+    highCutFilter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
+}
+
+void DelayEngine::FeedbackPath::prepare(const juce::dsp::ProcessSpec& spec, int factor, bool useHighQuality)
+{
+    highQuality = useHighQuality;
+    oversampler.setFactor(factor);
+    linearPhaseOversampler.setFactor(factor);
+    latency = highQuality ? linearPhaseOversampler.getLatency() : oversampler.getLatency();
+    
+    // The filters run at the oversampled rate. Re-preparing with the same
+    // channel count does not allocate.
+    auto filterSpec = spec;
+    filterSpec.numChannels = 2;
+    filterSpec.sampleRate *= factor;
+    filterSpec.maximumBlockSize *= juce::uint32(factor);
+    lowCutFilter.prepare(filterSpec);
+    highCutFilter.prepare(filterSpec);
+    
+    reset();
+}
+
+void DelayEngine::FeedbackPath::reset() noexcept
+{
+    lowCutFilter.reset();
+    highCutFilter.reset();
+    saturator.reset();
+    oversampler.reset();
+    linearPhaseOversampler.reset();
+    
+    // The next setCutoffs() computes the coefficients for the new rate
+    lowCut = 0.0f;
+    highCut = 0.0f;
+}
+
+void DelayEngine::FeedbackPath::setCutoffs(float newLowCut, float newHighCut) noexcept
+{
+    if (newLowCut != lowCut) {
+        lowCut = newLowCut;
+        lowCutFilter.setCutoffFrequency(lowCut);
+    }
+    if (newHighCut != highCut) {
+        highCut = newHighCut;
+        highCutFilter.setCutoffFrequency(highCut);
+    }
+}
+
+void DelayEngine::FeedbackPath::process(float& left, float& right, float drive) noexcept
+{
+    saturator.setDrive(drive);
+    
+    auto nonlinear = [this](float& l, float& r)
+    {
+        saturator.process(l, r);
+        
+        l = lowCutFilter.processSample(0, l);
+        l = highCutFilter.processSample(0, l);
+        
+        r = lowCutFilter.processSample(1, r);
+        r = highCutFilter.processSample(1, r);
+    };
+    
+    if (highQuality) {
+        linearPhaseOversampler.process(left, right, nonlinear);
+    } else {
+        oversampler.process(left, right, nonlinear);
+    }
+}
+
+//==============================================================================
+void DelayEngine::prepare(const juce::dsp::ProcessSpec& newSpec)
+{
+    spec = newSpec;
+    sampleRate = float(spec.sampleRate);
+    
+    double duration = 0.02;
+    gainSmoother.reset(spec.sampleRate, duration);
+    mixSmoother.reset(spec.sampleRate, duration);
+    feedbackSmoother.reset(spec.sampleRate, duration);
+    stereoSmoother.reset(spec.sampleRate, duration);
+    lowCutSmoother.reset(spec.sampleRate, duration);
+    highCutSmoother.reset(spec.sampleRate, duration);
+    driveSmoother.reset(spec.sampleRate, duration);
+    diffuseSmoother.reset(spec.sampleRate, duration);
+    
+    double numSamples = (maxDelayTime / 1000.0) * spec.sampleRate;
+    int maxDelayInSamples = int(std::ceil(numSamples));
+    delayLineL.setMaximumDelayInSamples(maxDelayInSamples);
+    delayLineR.setMaximumDelayInSamples(maxDelayInSamples);
+    
+    diffuser.prepare(spec.sampleRate);
+    outputGuard.prepare(spec.sampleRate);
+    
+    coeff = 1.0f - std::exp(-1.0f / (0.05f * sampleRate));
+    waitInc = 1.0f / (0.3f * sampleRate);
+    wetFadeInc = 1.0f / (wetFadeTime * sampleRate);
+    
+    warmupSamples = int(warmupTime * sampleRate);
+    crossfadeInc = 1.0f / (crossfadeTime * sampleRate);
+}
+
+void DelayEngine::reset(const DelayParameters& parameters) noexcept
+{
+    gain = 0.0f;
+    gainSmoother.setCurrentAndTargetValue(parameters.gain);
+    
+    mix = 1.0f;
+    mixSmoother.setCurrentAndTargetValue(parameters.mix);
+    
+    // Feedback glides in from wherever it was, so it never starts at full level
+    feedback = 0.0f;
+    feedbackSmoother.setTargetValue(parameters.feedback);
+    
+    panL = 0.0f;
+    panR = 1.0f;
+    stereoSmoother.setCurrentAndTargetValue(parameters.stereo);
+    
+    lowCut = 20.0f;
+    lowCutSmoother.setCurrentAndTargetValue(parameters.lowCut);
+    
+    highCut = 20000.0f;
+    highCutSmoother.setCurrentAndTargetValue(parameters.highCut);
+    
+    drive = 1.0f;
+    driveSmoother.setCurrentAndTargetValue(parameters.drive);
+    
+    diffuse = 0.0f;
+    diffuseSmoother.setCurrentAndTargetValue(parameters.diffuse);
+    
+    delayTime = 0.0f;
+    bypassed = parameters.bypassed;
+    
+    activePath = 0;
+    crossfading = false;
+    paths[0].prepare(spec, parameters.oversampling, parameters.highQuality);
+    resetFeedbackPath();
+    
+    delayInSamples = 0.0f;
+    targetDelay = 0.0f;
+    fade = 1.0f;
+    fadeTarget = 1.0f;
+    wait = 0.0f;
+    
+    wetFade = parameters.muted ? 0.0f : 1.0f;
+    wetFadeTarget = wetFade;
+}
+
+void DelayEngine::setTargets(const DelayParameters& parameters) noexcept
+{
+    gainSmoother.setTargetValue(parameters.gain);
+    mixSmoother.setTargetValue(parameters.mix);
+    feedbackSmoother.setTargetValue(parameters.feedback);
+    stereoSmoother.setTargetValue(parameters.stereo);
+    lowCutSmoother.setTargetValue(parameters.lowCut);
+    highCutSmoother.setTargetValue(parameters.highCut);
+    driveSmoother.setTargetValue(parameters.drive);
+    diffuseSmoother.setTargetValue(parameters.diffuse);
+    
+    // Ducking: the delay time jumps once per block, the engine fades around it
+    delayTime = parameters.delayTime;
+    bypassed = parameters.bypassed;
+    wetFadeTarget = parameters.muted ? 0.0f : 1.0f;
+    
+    // A switch that comes in while another one is still fading waits for
+    // the next block
+    int factor = parameters.oversampling;
+    auto& path = paths[activePath];
+    if (!crossfading && (factor != path.oversampler.getFactor() || parameters.highQuality != path.highQuality)) {
+        startCrossfade(factor, parameters.highQuality);
+    }
+}
+
+void DelayEngine::startCrossfade(int factor, bool highQuality) noexcept
+{
+    auto& next = paths[1 - activePath];
+    next.prepare(spec, factor, highQuality);
+    
+    crossfading = true;
+    warmup = warmupSamples;
+    crossfade = 0.0f;
+}
+
+void DelayEngine::smoothen() noexcept
+{
+    gain = gainSmoother.getNextValue();
+    mix = mixSmoother.getNextValue();
+    feedback = feedbackSmoother.getNextValue();
+    panningEqualPower(stereoSmoother.getNextValue(), panL, panR);
+    lowCut = lowCutSmoother.getNextValue();
+    highCut = highCutSmoother.getNextValue();
+    drive = driveSmoother.getNextValue();
+    diffuse = diffuseSmoother.getNextValue();
+}
+
+void DelayEngine::process(std::span<const float* const> input,
+                          std::span<float* const> output,
+                          int numSamples,
+                          const DelayParameters& parameters) noexcept
+{
+    jassert(!input.empty() && !output.empty());
+    
+    setTargets(parameters);
+    
+    const float* inputL = input[0];
+    const float* inputR = input[input.size() > 1 ? 1 : 0];
+    
+    if (output.size() > 1) {
+        processStereo(inputL, inputR, output[0], output[1], numSamples);
+    } else {
+        processMono(inputL, output[0], numSamples);
+    }
+    
+    // Up to 2 channels, so referring to them doesn't allocate
+    juce::AudioBuffer<float> buffer(output.data(), int(output.size()), numSamples);
+    if (!outputGuard.process(buffer)) {
+        DBG("!!! WARNING: nan, inf or runaway feedback in output, resetting feedback !!!");
+        resetFeedbackPath();
+    }
+}
+
+void DelayEngine::processStereo(const float* inputL, const float* inputR,
+                                float* outputL, float* outputR, int numSamples) noexcept
+{
+    // Ducking
+    float newTargetDelay = delayTime / 1000.0f * sampleRate;
+    
+    if (newTargetDelay != targetDelay) {
+        targetDelay = newTargetDelay;
+        
+        if (delayInSamples == 0.0f) {
+            delayInSamples = targetDelay;
+        }
+        else {
+            wait = waitInc;
+            fadeTarget = 0.0f;
+        }
+    }
+    
+    for (int offset = 0; offset < numSamples; offset += duckingBlockSize) {
+        int blockSize = std::min(duckingBlockSize, numSamples - offset);
+        
+        float duckingGain[duckingBlockSize];
+        int switchIndex = renderDuckingGain(duckingGain, blockSize);
+        
+        for (int i = 0; i < blockSize; ++i) {
+            duckingGain[i] *= nextWetFade();
+        }
+        
+        for (int i = 0; i < blockSize; ++i) {
+            int sample = offset + i;
+            smoothen();
+            
+            auto& path = paths[activePath];
+            auto& next = paths[1 - activePath];
+            
+            path.setCutoffs(lowCut, highCut);
+            if (crossfading) {
+                next.setCutoffs(lowCut, highCut);
+            }
+            
+            float dryL = inputL[sample];
+            float dryR = inputR[sample];
+            
+            float mono = (dryL + dryR) * 0.5f;
+            
+            delayLineL.write(mono * panL + feedbackL);
+            delayLineR.write(mono * panR + feedbackR);
+            
+            // The delay jumps to its new length on the sample after the wait is over
+            float readDelay = i > switchIndex ? targetDelay : delayInSamples;
+            float wetL = path.read(delayLineL, readDelay);
+            float wetR = path.read(delayLineR, readDelay);
+            
+            feedbackL = path.readFeedback(delayLineL, readDelay, wetL);
+            feedbackR = path.readFeedback(delayLineR, readDelay, wetR);
+            
+            // Ducking
+            wetL *= duckingGain[i];
+            wetR *= duckingGain[i];
+            
+            feedbackL *= duckingGain[i] * feedback;
+            feedbackR *= duckingGain[i] * feedback;
+            path.process(feedbackL, feedbackR, drive);
+            
+            if (crossfading) {
+                float nextWetL = next.read(delayLineL, readDelay);
+                float nextWetR = next.read(delayLineR, readDelay);
+                
+                float nextFeedbackL = next.readFeedback(delayLineL, readDelay, nextWetL) * duckingGain[i] * feedback;
+                float nextFeedbackR = next.readFeedback(delayLineR, readDelay, nextWetR) * duckingGain[i] * feedback;
+                next.process(nextFeedbackL, nextFeedbackR, drive);
+                
+                nextWetL *= duckingGain[i];
+                nextWetR *= duckingGain[i];
+                
+                float x = nextCrossfade();
+                wetL += x * (nextWetL - wetL);
+                wetR += x * (nextWetR - wetR);
+                feedbackL += x * (nextFeedbackL - feedbackL);
+                feedbackR += x * (nextFeedbackR - feedbackR);
+                finishCrossfade();
+            }
+            
+            diffuser.process(feedbackL, feedbackR, diffuse);
+            
+            float mixL = dryL + wetL * mix;
+            float mixR = dryR + wetR * mix;
+            
+            float outL = mixL * gain;
+            float outR = mixR * gain;
+            
+            if (bypassed) {
+                outL = dryL;
+                outR = dryR;
+            }
+            
+            outputL[sample] = outL;
+            outputR[sample] = outR;
+        }
+        
+        if (switchIndex < blockSize) {
+            delayInSamples = targetDelay;
+        }
+    }
+}
+
+void DelayEngine::processMono(const float* input, float* output, int numSamples) noexcept
+{
+    delayInSamples = delayTime / 1000.0f * sampleRate;
+    
+    for (int sample = 0; sample < numSamples; ++sample) {
+        smoothen();
+        
+        float dry = input[sample];
+        
+        delayLineL.write(dry + feedbackL);
+        
+        float wet = paths[activePath].read(delayLineL, delayInSamples);
+        if (crossfading) {
+            float nextWet = paths[1 - activePath].read(delayLineL, delayInSamples);
+            wet += nextCrossfade() * (nextWet - wet);
+            finishCrossfade();
+        }
+        wet *= nextWetFade();
+        
+        feedbackL = wet * feedback;
+        
+        float out = (dry + wet * mix) * gain;
+        
+        if (bypassed) {
+            out = dry;
+        }
+        
+        output[sample] = out;
+    }
+}
+
+void DelayEngine::resetFeedbackPath() noexcept
+{
+    delayLineL.reset();
+    delayLineR.reset();
+    
+    feedbackL = 0.0f;
+    feedbackR = 0.0f;
+    
+    paths[0].reset();
+    paths[1].reset();
+    diffuser.reset();
+    outputGuard.reset();
+}
+
+int DelayEngine::renderDuckingGain(float* dest, int numSamples) noexcept
+{
+    // Not waiting, so the fade just follows its target for the whole block
+    if (wait == 0.0f) {
+        onePoleRamp(dest, numSamples, fade, fadeTarget, coeff);
+        return numSamples;
+    }
+    
+    // The wait is over after the sample where wait + (n + 1) * waitInc reaches 1
+    int switchIndex = int(std::ceil((1.0f - wait) / waitInc)) - 1;
+    switchIndex = std::max(switchIndex, 0);
+    
+    if (switchIndex >= numSamples) {
+        onePoleRamp(dest, numSamples, fade, fadeTarget, coeff);
+        wait += waitInc * float(numSamples);
+        return numSamples;
+    }
+    
+    // Fade out up to and including the switch sample, then fade back in
+    onePoleRamp(dest, switchIndex + 1, fade, fadeTarget, coeff);
+    wait = 0.0f;
+    fadeTarget = 1.0f;
+    onePoleRamp(dest + switchIndex + 1, numSamples - switchIndex - 1, fade, fadeTarget, coeff);
+    return switchIndex;
+}
@@ -0,0 +1,234 @@
+/*
+  ==============================================================================
+
+    DelayEngine.h
+    Created: 31 Oct 2026 10:04:27am
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <span>
+#include "DelayLine.h"
+#include "Diffuser.h"
+#include "DSP.h"
+#include "Oversampling.h"
+#include "ProtectYourEars.h"
+
+//==============================================================================
+// Where the parameters should be for the next block, in the units the DSP
+// works in. Everything but the delay time glides there over 20 ms; the delay
+// time jumps and the engine ducks the wet signal around the jump.
+struct DelayParameters
+{
+    float gain = 1.0f;          // linear
+    float delayTime = 100.0f;   // ms, already resolved if tempo synced
+    float mix = 1.0f;           // 0 to 1
+    float feedback = 0.0f;      // -1 to 1
+    float stereo = 0.0f;        // -1 to 1
+    float lowCut = 20.0f;       // Hz
+    float highCut = 20000.0f;   // Hz
+    float drive = 1.0f;         // gain into the saturator
+    float diffuse = 0.0f;       // 0 to 1
+    int oversampling = 1;       // factor for the feedback nonlinearity and filters
+    bool bypassed = false;
+    bool muted = false;         // fades the wet signal out and holds it silent
+    bool highQuality = false;   // for offline rendering, see DelayEngine
+};
+
+//==============================================================================
+/*
+    The complete delay: delay lines, ducking, the feedback loop and the mix.
+    Knows nothing about plug-in hosts, so it can run wherever there is audio
+    in float buffers. One or two input channels, one or two output channels;
+    with a single output channel it runs the plain mono delay.
+
+    In high quality the delay lines are read with Lagrange instead of Hermite
+    interpolation and the oversampler, if one is on, uses linear phase
+    filters instead of allpasses. The oversampling factor stays the user's,
+    so offline renders differ from realtime ones only in the kernels. Either
+    way the feedback is read early by the oversampler's latency, so
+    oversampling doesn't move the repeats. Switching the quality or the oversampling
+    factor brings up a second feedback loop next to the running one, lets
+    it settle for 20 ms and then crossfades to it over 20 ms, so the switch
+    can't be heard.
+
+    prepare() allocates, everything else is realtime safe.
+*/
+class DelayEngine
+{
+public:
+    DelayEngine() = default;
+    
+    static constexpr float maxDelayTime = 5000.0f;
+    
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    
+    // Clears the delay and jumps straight to the given parameters
+    void reset(const DelayParameters& parameters) noexcept;
+    
+    // Input and output may be the same buffers
+    void process(std::span<const float* const> input,
+                 std::span<float* const> output,
+                 int numSamples,
+                 const DelayParameters& parameters) noexcept;
+    
+    // True once a mute has faded the wet signal all the way out
+    bool isWetMuted() const noexcept
+    {
+        return wetFade == 0.0f;
+    }
+    
+private:
+    void setTargets(const DelayParameters& parameters) noexcept;
+    void smoothen() noexcept;
+    
+    void processStereo(const float* inputL, const float* inputR,
+                       float* outputL, float* outputR, int numSamples) noexcept;
+    void processMono(const float* input, float* output, int numSamples) noexcept;
+    
+    // The part of the feedback loop that holds state and depends on the
+    // oversampling factor and quality
+    struct FeedbackPath
+    {
+        FeedbackPath();
+        
+        void prepare(const juce::dsp::ProcessSpec& spec, int factor, bool useHighQuality);
+        void reset() noexcept;
+        void setCutoffs(float newLowCut, float newHighCut) noexcept;
+        void process(float& left, float& right, float drive) noexcept;
+        
+        float read(const DelayLine& delayLine, float delayInSamples) const noexcept
+        {
+            return highQuality ? delayLine.readLagrange(delayInSamples) : delayLine.read(delayInSamples);
+        }
+        
+        // The feedback is read early by the oversampler's latency. Without
+        // oversampling there is none and the wet tap, already read at the
+        // same delay, is used again.
+        float readFeedback(const DelayLine& delayLine, float delayInSamples, float wet) const noexcept
+        {
+            return latency > 0.0f ? read(delayLine, delayInSamples - latency) : wet;
+        }
+        
+        juce::dsp::StateVariableTPTFilter<float> lowCutFilter;
+        juce::dsp::StateVariableTPTFilter<float> highCutFilter;
+        Saturator saturator;
+        Oversampler oversampler;
+        LinearPhaseOversampler linearPhaseOversampler;
+        
+        // What the coefficients were last computed for; working them out
+        // takes a tan(), so it is skipped while the cutoffs hold still
+        float lowCut = 0.0f;
+        float highCut = 0.0f;
+        
+        // The oversampler delays the loop by this much, so the feedback is
+        // read that much earlier to keep the repeats on time
+        float latency = 0.0f;
+        
+        bool highQuality = false;
+    };
+    
+    // Switching paths: the next one runs alongside for warmupSamples, then
+    // the output crossfades to it
+    void startCrossfade(int factor, bool highQuality) noexcept;
+    
+    float nextCrossfade() noexcept
+    {
+        if (warmup > 0) {
+            warmup -= 1;
+            return 0.0f;
+        }
+        crossfade = std::min(crossfade + crossfadeInc, 1.0f);
+        return crossfade;
+    }
+    
+    void finishCrossfade() noexcept
+    {
+        if (crossfading && crossfade == 1.0f) {
+            activePath = 1 - activePath;
+            crossfading = false;
+        }
+    }
+    
+    // Fills dest with the ducking curve for the next numSamples samples and
+    // returns the index of the sample after which the delay switches to its
+    // target, or numSamples if it does not switch in this chunk.
+    int renderDuckingGain(float* dest, int numSamples) noexcept;
+    
+    // Clears everything that recirculates, used when the output guard trips
+    void resetFeedbackPath() noexcept;
+    
+    float nextWetFade() noexcept
+    {
+        if (wetFadeTarget > wetFade) {
+            wetFade = std::min(wetFade + wetFadeInc, 1.0f);
+        } else {
+            wetFade = std::max(wetFade - wetFadeInc, 0.0f);
+        }
+        return wetFade;
+    }
+    
+    juce::dsp::ProcessSpec spec { 44100.0, 512, 2 };
+    float sampleRate = 44100.0f;
+    
+    DelayLine delayLineL, delayLineR;
+    float feedbackL = 0.0f;
+    float feedbackR = 0.0f;
+    Diffuser diffuser;
+    OutputGuard outputGuard;
+    
+    FeedbackPath paths[2];
+    int activePath = 0;
+    bool crossfading = false;
+    int warmup = 0;
+    float crossfade = 0.0f;
+    float crossfadeInc = 0.0f;
+    int warmupSamples = 0;
+    static constexpr float warmupTime = 0.02f;
+    static constexpr float crossfadeTime = 0.02f;
+    
+    // Smoothed parameters, the values for the current sample
+    juce::LinearSmoothedValue<float> gainSmoother;
+    juce::LinearSmoothedValue<float> mixSmoother;
+    juce::LinearSmoothedValue<float> feedbackSmoother;
+    juce::LinearSmoothedValue<float> stereoSmoother;
+    juce::LinearSmoothedValue<float> lowCutSmoother;
+    juce::LinearSmoothedValue<float> highCutSmoother;
+    juce::LinearSmoothedValue<float> driveSmoother;
+    juce::LinearSmoothedValue<float> diffuseSmoother;
+    float gain = 0.0f;
+    float mix = 1.0f;
+    float feedback = 0.0f;
+    float panL = 0.0f;
+    float panR = 1.0f;
+    float lowCut = 20.0f;
+    float highCut = 20000.0f;
+    float drive = 1.0f;
+    float diffuse = 0.0f;
+    float delayTime = 0.0f;
+    bool bypassed = false;
+    
+    // Ducking
+    float delayInSamples = 0.0f;
+    float targetDelay = 0.0f;
+    float fade = 0.0f;
+    float fadeTarget = 0.0f;
+    float coeff = 0.0f;
+    float wait = 0.0f;
+    float waitInc = 0.0f;
+    
+    // The ducking gain is rendered ahead in chunks of this many samples
+    static constexpr int duckingBlockSize = 64;
+    
+    // Muting, a linear fade of the wet signal
+    float wetFade = 1.0f;
+    float wetFadeTarget = 1.0f;
+    float wetFadeInc = 0.0f;
+    static constexpr float wetFadeTime = 0.02f;
+    
+    JUCE_DECLARE_NON_COPYABLE (DelayEngine)
+};
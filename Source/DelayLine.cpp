@@ -15,7 +15,8 @@ void DelayLine::setMaximumDelayInSamples(int maxLengthInSamples)
 {
     jassert(maxLengthInSamples > 0);
     
-    int paddedLength = maxLengthInSamples + 2;
+    // Room for the interpolators to read past the longest delay
+    int paddedLength = maxLengthInSamples + 4;
     
     if (bufferLength < paddedLength) {
         bufferLength = paddedLength;
@@ -104,7 +105,7 @@ float DelayLine::read(float delayInSamples) const noexcept
             if (readIndexB < 0) {
                 readIndexB += bufferLength;
                 if (readIndexA < 0) {
-                    readIndexA = bufferLength;
+                    readIndexA += bufferLength;
                 }
             }
         }
@@ -125,7 +126,56 @@ float DelayLine::read(float delayInSamples) const noexcept
     float stage1 = a * fraction - b;
     float stage2 = stage1 * fraction + slope0;
     return stage2 * fraction + sampleB;
+    
+}
 
+float DelayLine::readLagrange(float delayInSamples) const noexcept
+{
+    jassert(delayInSamples >= 2.0f);
+    jassert(delayInSamples <= bufferLength - 4.0f);
+    
+    int integerDelay = int(delayInSamples);
+    
+    // Six taps from integerDelay - 2 to integerDelay + 3, oldest last
+    float samples[6];
+    int readIndex = writeIndex - integerDelay + 2;
+    if (readIndex < 0) {
+        readIndex += bufferLength;
+    }
+    for (int i = 0; i < 6; ++i) {
+        samples[i] = buffer[size_t(readIndex)];
+        readIndex -= 1;
+        if (readIndex < 0) {
+            readIndex += bufferLength;
+        }
+    }
+    
+    // The basis polynomials share most of their factors, so build them from
+    // running products from the left and from the right
+    float fraction = delayInSamples - float(integerDelay);
+    float d[6];
+    for (int i = 0; i < 6; ++i) {
+        d[i] = fraction - float(i - 2);
+    }
+    
+    float left[6], right[6];
+    left[0] = 1.0f;
+    right[5] = 1.0f;
+    for (int i = 1; i < 6; ++i) {
+        left[i] = left[i - 1] * d[i - 1];
+        right[5 - i] = right[6 - i] * d[6 - i];
+    }
+    
+    // 1 / prod(k - j) over j != k, for k = -2 ... 3
+    static constexpr float weights[6] = {
+        -1.0f / 120.0f, 1.0f / 24.0f, -1.0f / 12.0f, 1.0f / 12.0f, -1.0f / 24.0f, 1.0f / 120.0f,
+    };
+    
+    float result = 0.0f;
+    for (int i = 0; i < 6; ++i) {
+        result += samples[i] * left[i] * right[i] * weights[i];
+    }
+    return result;
 }
 
 
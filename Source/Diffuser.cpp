@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    Diffuser.cpp
+    Created: 19 Oct 2026 2:47:03pm
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>     // For MathConstants
+#include "Diffuser.h"
+
+// Mutually prime-ish stage lengths in ms, slightly different per channel
+static constexpr float stageDelayTimes[] =
+{
+    1.53f, 3.41f, 5.97f, 8.43f,     // left
+    1.79f, 3.07f, 6.31f, 7.97f,     // right
+};
+
+static constexpr float lfoRates[] =
+{
+    0.31f, 0.43f, 0.57f, 0.71f,     // Hz
+    0.37f, 0.47f, 0.61f, 0.79f,
+};
+
+static constexpr float modDepthTime = 0.3f;     // ms
+
+void Diffuser::prepare(double sampleRate)
+{
+    float samplesPerMs = float(sampleRate / 1000.0);
+    
+    for (auto& stage : stages) {
+        stage.setMaximumDelayInSamples(int(std::ceil(maxDelayTime * samplesPerMs)));
+    }
+    
+    for (int lane = 0; lane < numLanes; ++lane) {
+        delayInSamples[lane] = stageDelayTimes[lane] * samplesPerMs;
+        lfoInc[lane] = 2.0f * std::sin(juce::MathConstants<float>::pi * lfoRates[lane] / float(sampleRate));
+    }
+    modDepth = modDepthTime * samplesPerMs;
+    
+    reset();
+}
+
+void Diffuser::reset() noexcept
+{
+    for (auto& stage : stages) {
+        stage.reset();
+    }
+    
+    for (int lane = 0; lane < numLanes; ++lane) {
+        // Spread the starting phases so the stages don't move together
+        float phase = juce::MathConstants<float>::twoPi * float(lane) / float(numLanes);
+        lfoSin[lane] = std::sin(phase);
+        lfoCos[lane] = std::cos(phase);
+    }
+    
+    bypassed = false;
+}
+
+void Diffuser::process(float& left, float& right, float amount) noexcept
+{
+    if (amount == 0.0f) {
+        bypassed = true;
+        return;
+    }
+    
+    // Whatever was left in the stages is stale by now
+    if (bypassed) {
+        reset();
+    }
+    
+    float signal[2] = { left, right };
+    
+    for (int lane = 0; lane < numLanes; ++lane) {
+        float& x = signal[lane / numStages];
+        
+        // The line's newest value is one sample old until this one is written
+        float delayed = stages[lane].read(delayInSamples[lane] + modDepth * lfoSin[lane] - 1.0f);
+        float w = x + allpassGain * delayed;
+        stages[lane].write(w);
+        x = delayed - allpassGain * w;
+    }
+    
+    for (int lane = 0; lane < numLanes; ++lane) {
+        lfoSin[lane] += lfoInc[lane] * lfoCos[lane];
+        lfoCos[lane] -= lfoInc[lane] * lfoSin[lane];
+    }
+    
+    left += amount * (signal[0] - left);
+    right += amount * (signal[1] - right);
+}
@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+
+    Diffuser.h
+    Created: 19 Oct 2026 2:47:03pm
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "DelayLine.h"
+
+// Chain of modulated Schroeder allpasses that smears the repeats into a wash.
+// Each stage of each channel is a DelayLine read with its cubic interpolation.
+// When the amount sits at 0 the network is skipped, and it starts again from
+// silence when the amount comes back up.
+class Diffuser
+{
+public:
+    void prepare(double sampleRate);
+    
+    void reset() noexcept;
+    
+    // amount is 0 (dry) to 1 (fully diffused)
+    void process(float& left, float& right, float amount) noexcept;
+    
+private:
+    static constexpr int numStages = 4;
+    static constexpr int numLanes = numStages * 2;  // left stages, then right stages
+    static constexpr float maxDelayTime = 10.0f;    // ms
+    static constexpr float allpassGain = 0.6f;
+    
+    DelayLine stages[numLanes];
+    
+    float delayInSamples[numLanes] = {};
+    
+    // Sine oscillators that wobble the delay times
+    float lfoSin[numLanes] = {};
+    float lfoCos[numLanes] = {};
+    float lfoInc[numLanes] = {};
+    float modDepth = 0.0f;
+    
+    bool bypassed = false;
+};
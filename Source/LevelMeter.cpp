@@ -13,11 +13,11 @@
 #include "LookAndFeel.h"
 
 //==============================================================================
-LevelMeter::LevelMeter(Measurement& measurementL_, Measurement& measurementR_) : measurementL(measurementL_), measurementR(measurementR_), dbLevelL(clampdB), dbLevelR(clampdB)
+LevelMeter::LevelMeter(Measurement& measurementL_, Measurement& measurementR_) : measurementL(measurementL_), measurementR(measurementR_), dbLevelL(clampdB), dbLevelR(clampdB), dbRmsL(clampdB), dbRmsR(clampdB)
 {
     setOpaque(true);
+    lastTick = juce::Time::getMillisecondCounterHiRes();
     startTimerHz(refreshRate);
-    decay = 1.0f - static_cast<float>(std::exp(-1.0f / (float(refreshRate) * 0.2)));
 }
 
 LevelMeter::~LevelMeter()
@@ -26,53 +26,164 @@ LevelMeter::~LevelMeter()
 
 void LevelMeter::paint (juce::Graphics& g)
 {
-    const auto bounds = getLocalBounds();
-    
     g.fillAll (Colors::LevelMeter::background);
-    drawLevel(g, dbLevelL, 0, 7);
-    drawLevel(g, dbLevelR, 9, 7);
+    drawLevel(g, paintedL, barXL);
+    drawLevel(g, paintedR, barXR);
+    
+    float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (!scaleImage.isValid() || scale != scaleImageScale) {
+        renderScale(scale);
+    }
+    
+    g.drawImage(scaleImage, getLocalBounds().toFloat());
+}
 
+void LevelMeter::resized()
+{
+    maxPos = 4.0f;
+    minPos = float(getHeight() - 4.0f);
+    
+    scaleImage = {};    // rendered again on the next paint
+    
+    paintedL = barPositions(dbLevelL, dbRmsL, clipHoldL > 0.0f);
+    paintedR = barPositions(dbLevelR, dbRmsR, clipHoldR > 0.0f);
+}
+
+void LevelMeter::renderScale(float scale)
+{
+    if (getWidth() <= 0 || getHeight() <= 0) { return; }
+    
+    // Render at the display's pixel density so the labels stay sharp
+    scaleImageScale = scale;
+    scaleImage = juce::Image(juce::Image::ARGB,
+                             juce::roundToInt(float(getWidth()) * scale),
+                             juce::roundToInt(float(getHeight()) * scale),
+                             true);
+    
+    juce::Graphics g(scaleImage);
+    g.addTransform(juce::AffineTransform::scale(scale));
     g.setFont (Fonts::getFont(10.0f));
     
     for (float db = maxdB; db >= mindB; db -= stepdB) {
         int y = positionForLevel(db);
         
         g.setColour (Colors::LevelMeter::tickLine);
-        g.fillRect(0, y, 16., 1);
+        g.fillRect(0, y, 16, 1);
         
         g.setColour(Colors::LevelMeter::tickLabel);
-        g.drawSingleLineText(juce::String(int(db)), bounds.getWidth(), y + 3, juce::Justification::right);
+        g.drawSingleLineText(juce::String(int(db)), getWidth(), y + 3, juce::Justification::right);
     }
-    
+}
 
+void LevelMeter::visibilityChanged()
+{
+    updateRefreshRate();
 }
 
-void LevelMeter::resized()
+void LevelMeter::parentHierarchyChanged()
 {
-    maxPos = 4.0f;
-    minPos = float(getHeight() - 4.0f);
+    updateRefreshRate();
+}
+
+void LevelMeter::mouseDown(const juce::MouseEvent&)
+{
+    setTruePeakMode(!truePeakMode);
 }
 
 void LevelMeter::timerCallback()
 {
-    updateLevel(measurementL.readAndReset(), levelL, dbLevelL);
-    updateLevel(measurementR.readAndReset(), levelR, dbLevelR);
+    // Capped, so a stalled message thread doesn't make the meter jump
+    double now = juce::Time::getMillisecondCounterHiRes();
+    elapsed = float(std::min(now - lastTick, 1000.0) / 1000.0);
+    lastTick = now;
+    decay = 1.0f - std::exp(-elapsed / decayTime);
+    rmsCoeff = 1.0f - std::exp(-elapsed / rmsTime);
+    
+    readFrames(measurementL, levelL, meanSquareL, dbLevelL, dbRmsL, clipHoldL);
+    readFrames(measurementR, levelR, meanSquareR, dbLevelR, dbRmsR, clipHoldR);
+    
+    // Activity can only be seen here, and a minimized window doesn't tell
+    // its children, so this is polled as well
+    updateRefreshRate();
+    if (!isShowing()) { return; }
+    
+    // Only repaint the part of a bar that moved, and nothing at all if the
+    // levels did not change by a pixel
+    auto newL = barPositions(dbLevelL, dbRmsL, clipHoldL > 0.0f);
+    if (newL != paintedL) {
+        repaintBar(paintedL, newL, barXL);
+        paintedL = newL;
+    }
+    
+    auto newR = barPositions(dbLevelR, dbRmsR, clipHoldR > 0.0f);
+    if (newR != paintedR) {
+        repaintBar(paintedR, newR, barXR);
+        paintedR = newR;
+    }
+}
+
+void LevelMeter::updateRefreshRate()
+{
+    bool active = levelL > clampLevel || levelR > clampLevel
+               || meanSquareL > clampLevel * clampLevel || meanSquareR > clampLevel * clampLevel
+               || clipHoldL > 0.0f || clipHoldR > 0.0f;
+    
+    int rate = refreshRate;
+    if (!isShowing()) {
+        rate = hiddenRefreshRate;
+    } else if (!active) {
+        rate = idleRefreshRate;
+    }
+    
+    if (rate != currentRefreshRate) {
+        currentRefreshRate = rate;
+        startTimerHz(rate);
+    }
+}
+
+LevelMeter::BarPositions LevelMeter::barPositions(float level, float rms, bool clipped) const noexcept
+{
+    BarPositions bar;
+    bar.peak = juce::jlimit(0, getHeight(), positionForLevel(level));
+    bar.rms = juce::jlimit(0, getHeight(), std::max(positionForLevel(rms), positionForLevel(0.0f)));
+    bar.clipped = clipped;
+    return bar;
+}
+
+void LevelMeter::repaintBar(const BarPositions& oldBar, const BarPositions& newBar, int x)
+{
+    int top = std::min({ oldBar.peak, newBar.peak, oldBar.rms, newBar.rms });
+    int bottom = std::max({ oldBar.peak, newBar.peak, oldBar.rms, newBar.rms }) + 1;
+    
+    if (oldBar.clipped != newBar.clipped) {
+        top = 0;
+        bottom = std::max(bottom, 3);
+    }
     
-    repaint();
+    repaint(x, top, barWidth, bottom - top);
 }
 
-void LevelMeter::drawLevel(juce::Graphics& g, float level, int x, int width)
+void LevelMeter::drawLevel(juce::Graphics& g, const BarPositions& bar, int x)
 {
-    int y = positionForLevel(level);
-    if (level > 0.0f) {
-        int y0 = positionForLevel(0.0f);
+    int y0 = positionForLevel(0.0f);
+    if (bar.peak < y0) {
         g.setColour(Colors::LevelMeter::tooLoud);
-        g.fillRect(x, y, width, y0 - y);
+        g.fillRect(x, bar.peak, barWidth, y0 - bar.peak);
         g.setColour(Colors::LevelMeter::levelOK);
-        g.fillRect(x, y0, width, getHeight() - y0);
-    } else if (y < getHeight()) {
+        g.fillRect(x, y0, barWidth, getHeight() - y0);
+    } else if (bar.peak < getHeight()) {
         g.setColour(Colors::LevelMeter::levelOK);
-        g.fillRect(x, y, width, getHeight() - y);
+        g.fillRect(x, bar.peak, barWidth, getHeight() - bar.peak);
+    }
+    
+    if (bar.rms < getHeight()) {
+        g.setColour(Colors::LevelMeter::levelRMS);
+        g.fillRect(x, bar.rms, barWidth, getHeight() - bar.rms);
+    }
+    
+    if (bar.clipped) {
+        g.setColour(Colors::LevelMeter::tooLoud);
+        g.fillRect(x, 0, barWidth, 3);
     }
 }
 
@@ -90,3 +201,29 @@ void LevelMeter::updateLevel(float newLevel, float& smoothedLevel, float& leveld
         leveldB = clampdB;
     }
 }
+
+void LevelMeter::readFrames(Measurement& measurement, float& level, float& meanSquare, float& leveldB, float& rmsdB, float& clipHold) const
+{
+    float peak = 0.0f;
+    float sumOfSquares = 0.0f;
+    int numSamples = 0;
+    bool clipped = false;
+    
+    MeterFrame frame;
+    while (measurement.pop(frame)) {
+        peak = std::max(peak, truePeakMode ? frame.truePeak : frame.peak);
+        sumOfSquares += frame.sumOfSquares;
+        numSamples += frame.numSamples;
+        clipped |= frame.clipped;
+    }
+    
+    updateLevel(peak, level, leveldB);
+    
+    float newMeanSquare = numSamples > 0 ? sumOfSquares / float(numSamples) : 0.0f;
+    meanSquare += (newMeanSquare - meanSquare) * rmsCoeff;
+    
+    float rms = std::sqrt(meanSquare);
+    rmsdB = rms > clampLevel ? juce::Decibels::gainToDecibels(rms) : clampdB;
+    
+    clipHold = clipped ? clipHoldTime : std::max(clipHold - elapsed, 0.0f);
+}
@@ -24,6 +24,18 @@ public:
     
     void paint (juce::Graphics&) override;
     void resized() override;
+    
+    // Back to full rate straight away instead of on the next slow tick
+    void visibilityChanged() override;
+    void parentHierarchyChanged() override;
+    
+    // Clicking the meter switches between sample peak and true peak
+    void mouseDown(const juce::MouseEvent&) override;
+    
+    void setTruePeakMode(bool shouldShowTruePeak) noexcept
+    {
+        truePeakMode = shouldShowTruePeak;
+    }
 
 private:
     void timerCallback() override;
@@ -43,22 +55,75 @@ private:
 
     float dbLevelL;
     float dbLevelR;
+    float dbRmsL;
+    float dbRmsR;
     
     static constexpr int refreshRate = 60;
+    static constexpr int idleRefreshRate = 5;       // showing but silent
+    static constexpr int hiddenRefreshRate = 2;     // minimized or off screen
+    int currentRefreshRate = refreshRate;
     
+    // The ballistics are in seconds and follow the time since the last
+    // tick, so they don't stretch while the timer runs slowly
+    static constexpr float decayTime = 0.2f;
+    static constexpr float rmsTime = 0.3f;
+    static constexpr float clipHoldTime = 1.0f;
+    double lastTick = 0.0;
+    float elapsed = 0.0f;
     float decay = 0.0f;
+    float rmsCoeff = 0.0f;
     float levelL = clampLevel;
     float levelR = clampLevel;
+    float meanSquareL = 0.0f;
+    float meanSquareR = 0.0f;
+    float clipHoldL = 0.0f;     // seconds left
+    float clipHoldR = 0.0f;
+    
+    bool truePeakMode = false;
     
     int positionForLevel(float dbLevel) const noexcept
     {
         return int(std::round(juce::jmap(dbLevel, maxdB, mindB, maxPos, minPos)));
     }
+    
+    // What a bar looks like in pixels, so a timer tick can tell whether
+    // anything visible changed
+    struct BarPositions
+    {
+        int peak = 0;
+        int rms = 0;
+        bool clipped = false;
+        
+        bool operator==(const BarPositions&) const = default;
+    };
+    
+    BarPositions barPositions(float level, float rms, bool clipped) const noexcept;
+    
+    static constexpr int barWidth = 7;
+    static constexpr int barXL = 0;
+    static constexpr int barXR = 9;
+    
+    BarPositions paintedL, paintedR;
+    
+    // Tick lines and labels, drawn on top of the bars. Rendered again when
+    // the size or the display's scale factor changes.
+    juce::Image scaleImage;
+    float scaleImageScale = 0.0f;
+    
+    void renderScale(float scale);
+    
+    void repaintBar(const BarPositions& oldBar, const BarPositions& newBar, int x);
 
-    void drawLevel(juce::Graphics& g, float level, int x, int width);
+    void drawLevel(juce::Graphics& g, const BarPositions& bar, int x);
     
     void updateLevel(float newLevel, float& smoothedLevel, float& leveldB) const;
     
+    // Slows the timer down while the meter is hidden or has nothing to show
+    void updateRefreshRate();
+    
+    // Drains all frames pushed since the last tick and updates the ballistics
+    void readFrames(Measurement& measurement, float& level, float& meanSquare, float& leveldB, float& rmsdB, float& clipHold) const;
+    
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LevelMeter)
 };
@@ -10,11 +10,15 @@
 
 #include "LookAndFeel.h"
 
-const juce::Typeface::Ptr Fonts::typeface = juce::Typeface::createSystemTypefaceFor(BinaryData::LatoMedium_ttf, BinaryData::LatoMedium_ttfSize);
+const juce::Typeface::Ptr& Fonts::getTypeface()
+{
+    static const juce::Typeface::Ptr typeface = juce::Typeface::createSystemTypefaceFor(BinaryData::LatoMedium_ttf, BinaryData::LatoMedium_ttfSize);
+    return typeface;
+}
 
 juce::Font Fonts::getFont(float height)
 {
-    return juce::FontOptions(typeface).withMetricsKind(juce::TypefaceMetricsKind::legacy).withHeight(height);
+    return juce::FontOptions(getTypeface()).withMetricsKind(juce::TypefaceMetricsKind::legacy).withHeight(height);
 }
 
 juce::Font RotaryKnobLookAndFeel::getLabelFont([[maybe_unused]] juce::Label& label)
@@ -31,9 +35,20 @@ RotaryKnobLookAndFeel::RotaryKnobLookAndFeel()
     setColour(juce::CaretComponent::caretColourId, Colors::Knob::caret);
 }
 
-void RotaryKnobLookAndFeel::drawRotarySlider(juce::Graphics &g, int x, int y, int width, [[maybe_unused]] int height, float sliderPos, float rotaryStartAngle, float rotaryEndAngle, juce::Slider &slider)
+const juce::Image& RotaryKnobLookAndFeel::getKnobBody(int width, float scale, float rotaryStartAngle, float rotaryEndAngle)
 {
-    auto bounds = juce::Rectangle<int>(x, y, width, width).toFloat();
+    auto key = std::make_tuple(width, juce::roundToInt(scale * 100.0f), rotaryStartAngle, rotaryEndAngle);
+    auto it = knobBodies.find(key);
+    if (it != knobBodies.end()) {
+        return it->second;
+    }
+    
+    int pixels = juce::roundToInt(float(width) * scale);
+    juce::Image image(juce::Image::ARGB, pixels, pixels, true);
+    juce::Graphics g(image);
+    g.addTransform(juce::AffineTransform::scale(scale));
+    
+    auto bounds = juce::Rectangle<int>(0, 0, width, width).toFloat();
     auto knobRect = bounds.reduced(10.0f, 10.0f);
     
     auto path = juce::Path();
@@ -48,7 +63,7 @@ void RotaryKnobLookAndFeel::drawRotarySlider(juce::Graphics &g, int x, int y, in
     g.setGradientFill(gradient);
     g.fillEllipse(innerRect);
     
-    // Draw arc
+    // Background arc
     auto center = bounds.getCentre();
     auto radius = bounds.getWidth() / 2.0f;
     auto lineWidth = 3.0f;
@@ -60,6 +75,25 @@ void RotaryKnobLookAndFeel::drawRotarySlider(juce::Graphics &g, int x, int y, in
     g.setColour(Colors::Knob::trackBackground);
     g.strokePath(backgroundArc, strokeType);
     
+    return knobBodies.emplace(key, image).first->second;
+}
+
+void RotaryKnobLookAndFeel::drawRotarySlider(juce::Graphics &g, int x, int y, int width, [[maybe_unused]] int height, float sliderPos, float rotaryStartAngle, float rotaryEndAngle, juce::Slider &slider)
+{
+    auto bounds = juce::Rectangle<int>(x, y, width, width).toFloat();
+    
+    // Everything but the dial and the value arc comes from the cache
+    float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    g.drawImage(getKnobBody(width, scale, rotaryStartAngle, rotaryEndAngle), bounds);
+    
+    auto knobRect = bounds.reduced(10.0f, 10.0f);
+    auto innerRect = knobRect.reduced(2.0f, 2.0f);
+    auto center = bounds.getCentre();
+    auto radius = bounds.getWidth() / 2.0f;
+    auto lineWidth = 3.0f;
+    auto arcRadius = radius - lineWidth/2.0f;
+    auto strokeType = juce::PathStrokeType(lineWidth, juce::PathStrokeType::curved, juce::PathStrokeType::rounded);
+    
     // Dial
     auto dialRadius = innerRect.getHeight() / 2.0f - lineWidth;
     auto toAngle = rotaryStartAngle + sliderPos * (rotaryEndAngle - rotaryStartAngle);
@@ -130,6 +164,16 @@ MainLookAndFeel::MainLookAndFeel()
 {
     setColour(juce::GroupComponent::textColourId, Colors::Group::label);
     setColour(juce::GroupComponent::outlineColourId, Colors::Group::outline);
+    
+    setColour(juce::Label::textColourId, Colors::Knob::label);
+    setColour(juce::ComboBox::backgroundColourId, Colors::Button::background);
+    setColour(juce::ComboBox::textColourId, Colors::Button::text);
+    setColour(juce::ComboBox::outlineColourId, Colors::Button::outline);
+    setColour(juce::ComboBox::arrowColourId, Colors::Button::text);
+    setColour(juce::PopupMenu::backgroundColourId, Colors::Button::backgroundToggled);
+    setColour(juce::PopupMenu::textColourId, Colors::Button::text);
+    setColour(juce::PopupMenu::highlightedBackgroundColourId, Colors::Knob::trackActive);
+    setColour(juce::PopupMenu::highlightedTextColourId, Colors::Button::backgroundToggled);
 }
 
 juce::Font MainLookAndFeel::getLabelFont([[maybe_unused]] juce::Label& label)
@@ -11,6 +11,8 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <map>
+#include <tuple>
 
 namespace Colors
 {
@@ -54,6 +56,12 @@ namespace Colors
         const juce::Colour tickLabel { 80, 80, 80 };
         const juce::Colour tooLoud { 226, 74, 81 };
         const juce::Colour levelOK { 65, 206, 88 };
+        const juce::Colour levelRMS { 45, 160, 65 };
+    }
+
+    namespace Loudness
+    {
+        const juce::Colour text { 160, 155, 150 };
     }
 }
 
@@ -65,7 +73,9 @@ class Fonts
         static juce::Font getFont(float height = 16.0f);
     
     private:
-        static const juce::Typeface::Ptr typeface;
+        // Parsed on first use, so hosts that scan or render without opening
+        // an editor never touch the font
+        static const juce::Typeface::Ptr& getTypeface();
 };
 
 class RotaryKnobLookAndFeel : public juce::LookAndFeel_V4
@@ -91,6 +101,13 @@ class RotaryKnobLookAndFeel : public juce::LookAndFeel_V4
     private:
         juce::DropShadow dropShadow { Colors::Knob::dropShadow, 6, { 0, 3 } };
     
+        // Shadow, body and track of a knob, everything that doesn't depend on
+        // the value. Rendered once per size, scale factor and arc angles and
+        // shared by all knobs in all editors.
+        const juce::Image& getKnobBody(int width, float scale, float rotaryStartAngle, float rotaryEndAngle);
+    
+        std::map<std::tuple<int, int, float, float>, juce::Image> knobBodies;
+    
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RotaryKnobLookAndFeel)
 };
 
@@ -0,0 +1,186 @@
+/*
+  ==============================================================================
+
+    Loudness.cpp
+    Created: 19 Oct 2026 8:03:52pm
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "Loudness.h"
+
+static float loudnessFromMeanSquare(float meanSquare) noexcept
+{
+    return -0.691f + 10.0f * std::log10(std::max(meanSquare, 1e-12f));
+}
+
+static float meanSquareFromLoudness(float loudness) noexcept
+{
+    return std::pow(10.0f, (loudness + 0.691f) * 0.1f);
+}
+
+void LoudnessMeter::prepare(double sampleRate) noexcept
+{
+    // K-weighting pre-filter (high shelf) and RLB high-pass for any sample rate
+    double K = std::tan(juce::MathConstants<double>::pi * 1681.974450955533 / sampleRate);
+    double Q = 0.7071752369554196;
+    double Vh = std::pow(10.0, 3.999843853973347 / 20.0);
+    double Vb = std::pow(Vh, 0.4996667741545416);
+    double a0 = 1.0 + K / Q + K * K;
+    shelf.b0 = float((Vh + Vb * K / Q + K * K) / a0);
+    shelf.b1 = float(2.0 * (K * K - Vh) / a0);
+    shelf.b2 = float((Vh - Vb * K / Q + K * K) / a0);
+    shelf.a1 = float(2.0 * (K * K - 1.0) / a0);
+    shelf.a2 = float((1.0 - K / Q + K * K) / a0);
+    
+    K = std::tan(juce::MathConstants<double>::pi * 38.13547087602444 / sampleRate);
+    Q = 0.5003270373238773;
+    a0 = 1.0 + K / Q + K * K;
+    highpass.b0 = 1.0f;
+    highpass.b1 = -2.0f;
+    highpass.b2 = 1.0f;
+    highpass.a1 = float(2.0 * (K * K - 1.0) / a0);
+    highpass.a2 = float((1.0 - K / Q + K * K) / a0);
+    
+    for (int channel = 0; channel < 2; ++channel) {
+        for (int i = 0; i < 4; ++i) {
+            state[channel][i] = 0.0f;
+        }
+    }
+    
+    segmentLength = int(std::round(sampleRate * 0.1));
+    segmentPosition = 0;
+    segmentSum = 0.0f;
+    
+    // The reader may be busy with the FIFO and its history right now
+    readerResetPending.store(true);
+}
+
+void LoudnessMeter::process(const float* left, const float* right, int numSamples) noexcept
+{
+    // Mono runs through both lanes too but the second one doesn't count
+    const float* input[2] = { left, right != nullptr ? right : left };
+    const float weight[2] = { 1.0f, right != nullptr ? 1.0f : 0.0f };
+    
+    for (int sample = 0; sample < numSamples; ++sample) {
+        // Both channels go through the same filters side by side so the
+        // compiler can keep them in the lanes of one register
+        float energy = 0.0f;
+        for (int channel = 0; channel < 2; ++channel) {
+            float* z = state[channel];
+            
+            float x = input[channel][sample];
+            float y = shelf.b0 * x + z[0];
+            z[0] = shelf.b1 * x - shelf.a1 * y + z[1];
+            z[1] = shelf.b2 * x - shelf.a2 * y;
+            
+            x = y;
+            y = highpass.b0 * x + z[2];
+            z[2] = highpass.b1 * x - highpass.a1 * y + z[3];
+            z[3] = highpass.b2 * x - highpass.a2 * y;
+            
+            energy += weight[channel] * y * y;
+        }
+        
+        segmentSum += energy;
+        if (++segmentPosition == segmentLength) {
+            segments.push(segmentSum / float(segmentLength));
+            segmentPosition = 0;
+            segmentSum = 0.0f;
+        }
+    }
+}
+
+void LoudnessMeter::update() noexcept
+{
+    float meanSquare;
+    
+    // What is still queued was measured before prepare(), possibly at
+    // another rate, so it goes along with the rest of the old state
+    bool reset = readerResetPending.exchange(false);
+    if (reset) {
+        while (segments.pop(meanSquare)) { }
+        
+        history.fill(0.0f);
+        historyIndex = 0;
+        historyCount = 0;
+        resetIntegrated();
+        momentary = silence;
+        shortTerm = silence;
+    }
+    
+    bool changed = reset;
+    while (segments.pop(meanSquare)) {
+        changed = true;
+        history[size_t(historyIndex)] = meanSquare;
+        historyIndex = (historyIndex + 1) % shortTermSegments;
+        historyCount = std::min(historyCount + 1, shortTermSegments);
+        
+        // Every new segment completes a 400 ms gating block (75 % overlap)
+        if (historyCount >= momentarySegments) {
+            float blockLoudness = loudnessFromMeanSquare(meanOfLast(momentarySegments));
+            if (blockLoudness >= silence) {
+                int bin = std::min(int((blockLoudness - silence) * 10.0f), numBins - 1);
+                histogram[size_t(bin)] += 1;
+            }
+        }
+    }
+    
+    // Nothing new was measured, so the readings still hold
+    if (!changed) { return; }
+    
+    momentary = historyCount >= momentarySegments ? loudnessFromMeanSquare(meanOfLast(momentarySegments)) : silence;
+    shortTerm = historyCount >= shortTermSegments ? loudnessFromMeanSquare(meanOfLast(shortTermSegments)) : silence;
+    momentary = std::max(momentary, silence);
+    shortTerm = std::max(shortTerm, silence);
+    
+    updateIntegrated();
+}
+
+void LoudnessMeter::resetIntegrated() noexcept
+{
+    histogram.fill(0);
+    integrated = silence;
+}
+
+float LoudnessMeter::meanOfLast(int numSegments) const noexcept
+{
+    float sum = 0.0f;
+    for (int i = 1; i <= numSegments; ++i) {
+        int index = (historyIndex - i + shortTermSegments) % shortTermSegments;
+        sum += history[size_t(index)];
+    }
+    return sum / float(numSegments);
+}
+
+void LoudnessMeter::updateIntegrated() noexcept
+{
+    // The blocks are binned by loudness, so gating works on bin centres
+    double sum = 0.0;
+    std::uint64_t count = 0;
+    for (int bin = 0; bin < numBins; ++bin) {
+        if (histogram[size_t(bin)] > 0) {
+            sum += double(histogram[size_t(bin)]) * meanSquareFromLoudness(silence + (float(bin) + 0.5f) * 0.1f);
+            count += histogram[size_t(bin)];
+        }
+    }
+    
+    if (count == 0) {
+        integrated = silence;
+        return;
+    }
+    
+    float relativeGate = loudnessFromMeanSquare(float(sum / double(count))) - 10.0f;
+    int firstBin = std::max(0, int((relativeGate - silence) * 10.0f));
+    
+    sum = 0.0;
+    count = 0;
+    for (int bin = firstBin; bin < numBins; ++bin) {
+        sum += double(histogram[size_t(bin)]) * meanSquareFromLoudness(silence + (float(bin) + 0.5f) * 0.1f);
+        count += histogram[size_t(bin)];
+    }
+    
+    integrated = count > 0 ? std::max(loudnessFromMeanSquare(float(sum / double(count))), silence) : silence;
+}
@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    Loudness.h
+    Created: 19 Oct 2026 8:03:52pm
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include "Measurement.h"
+
+// Momentary, short-term and integrated loudness as in ITU-R BS.1770 / EBU R128.
+// The audio thread only K-weights the output and pushes the mean square of
+// every 100 ms segment into a FIFO. Windowing, gating and integration happen
+// in update(), which the processor calls from a message thread timer, so
+// the integrated value keeps counting while the editor is closed. There must
+// only ever be one reader.
+class LoudnessMeter
+{
+public:
+    static constexpr float silence = -70.0f;    // LUFS, also the absolute gate
+    
+    // Audio thread. For a mono output pass nullptr as right, the single
+    // channel then counts once as BS.1770 weights it.
+    void prepare(double sampleRate) noexcept;
+    void process(const float* left, const float* right, int numSamples) noexcept;
+    
+    // Reader thread
+    void update() noexcept;
+    void resetIntegrated() noexcept;
+    
+    float getMomentary() const noexcept { return momentary; }
+    float getShortTerm() const noexcept { return shortTerm; }
+    float getIntegrated() const noexcept { return integrated; }
+    
+private:
+    struct Biquad
+    {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+    };
+    
+    // Audio side
+    Biquad shelf, highpass;
+    float state[2][4] = {};     // per channel: shelf z1, z2, highpass z1, z2
+    int segmentLength = 0;
+    int segmentPosition = 0;
+    float segmentSum = 0.0f;
+    FrameFifo<float, 128> segments;
+    
+    // Set by prepare(), the reader clears its own state on the next update()
+    std::atomic<bool> readerResetPending { false };
+    
+    // Reader side
+    static constexpr int shortTermSegments = 30;    // 3 s
+    static constexpr int momentarySegments = 4;     // 400 ms
+    static constexpr int numBins = 750;             // 0.1 LU steps from -70 to +5 LUFS
+    
+    std::array<float, shortTermSegments> history {};
+    int historyIndex = 0;
+    int historyCount = 0;
+    std::array<std::uint32_t, numBins> histogram {};
+    
+    float momentary = silence;
+    float shortTerm = silence;
+    float integrated = silence;
+    
+    float meanOfLast(int numSegments) const noexcept;
+    void updateIntegrated() noexcept;
+};
@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    LoudnessDisplay.cpp
+    Created: 19 Oct 2026 8:41:27pm
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "LoudnessDisplay.h"
+#include "LookAndFeel.h"
+
+static juce::String stringFromLUFS(float value)
+{
+    if (value <= LoudnessMeter::silence) {
+        return "-inf";
+    }
+    return juce::String(value, 1);
+}
+
+//==============================================================================
+LoudnessDisplay::LoudnessDisplay(LoudnessMeter& loudness_) : loudness(loudness_)
+{
+    startTimerHz(refreshRate);
+}
+
+LoudnessDisplay::~LoudnessDisplay()
+{
+}
+
+void LoudnessDisplay::paint (juce::Graphics& g)
+{
+    g.setFont(Fonts::getFont(12.0f));
+    g.setColour(Colors::Loudness::text);
+    g.drawText(text, getLocalBounds(), juce::Justification::centredLeft);
+}
+
+void LoudnessDisplay::mouseDown(const juce::MouseEvent&)
+{
+    loudness.resetIntegrated();
+    timerCallback();
+}
+
+void LoudnessDisplay::visibilityChanged()
+{
+    updateRefreshRate();
+}
+
+void LoudnessDisplay::parentHierarchyChanged()
+{
+    updateRefreshRate();
+}
+
+void LoudnessDisplay::updateRefreshRate()
+{
+    int rate = isShowing() ? refreshRate : hiddenRefreshRate;
+    if (rate != currentRefreshRate) {
+        currentRefreshRate = rate;
+        startTimerHz(rate);
+    }
+}
+
+void LoudnessDisplay::timerCallback()
+{
+    // Still polled, a minimized window doesn't tell its children
+    updateRefreshRate();
+    if (!isShowing()) { return; }
+    
+    auto newText = "M " + stringFromLUFS(loudness.getMomentary())
+                 + "   S " + stringFromLUFS(loudness.getShortTerm())
+                 + "   I " + stringFromLUFS(loudness.getIntegrated())
+                 + " LUFS";
+    
+    if (newText != text) {
+        text = newText;
+        repaint();
+    }
+}
@@ -0,0 +1,49 @@
+/*
+  ==============================================================================
+
+    LoudnessDisplay.h
+    Created: 19 Oct 2026 8:41:27pm
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Loudness.h"
+
+//==============================================================================
+/*
+    Shows momentary, short-term and integrated loudness. The processor
+    keeps the meter up to date, this only reads it. Click to reset the
+    integrated value.
+*/
+class LoudnessDisplay  : public juce::Component, private juce::Timer
+{
+public:
+    LoudnessDisplay(LoudnessMeter& loudness);
+    ~LoudnessDisplay() override;
+    
+    void paint (juce::Graphics&) override;
+    void mouseDown(const juce::MouseEvent&) override;
+    
+    void visibilityChanged() override;
+    void parentHierarchyChanged() override;
+
+private:
+    void timerCallback() override;
+    
+    // Slow while hidden, switched as soon as the visibility changes
+    void updateRefreshRate();
+    
+    LoudnessMeter& loudness;
+    
+    static constexpr int refreshRate = 10;
+    static constexpr int hiddenRefreshRate = 1;
+    int currentRefreshRate = refreshRate;
+    
+    juce::String text;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoudnessDisplay)
+};
@@ -10,25 +10,107 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 
-struct Measurement
+// Summary of one channel of one processed block
+struct MeterFrame
 {
+    float peak = 0.0f;
+    float truePeak = 0.0f;
+    float sumOfSquares = 0.0f;
+    int numSamples = 0;
+    bool clipped = false;
+    
+    // Adds a later block, as if both had been measured as one
+    void merge(const MeterFrame& other) noexcept
+    {
+        peak = std::max(peak, other.peak);
+        truePeak = std::max(truePeak, other.truePeak);
+        sumOfSquares += other.sumOfSquares;
+        numSamples += other.numSamples;
+        clipped = clipped || other.clipped;
+    }
+};
+
+// Wait-free single-producer single-consumer queue. The audio thread pushes
+// one frame per block and the reader drains them on its timer, so no history
+// is lost between reads and the two sides never fight over the same cache line.
+template<typename Frame, int capacity>
+struct FrameFifo
+{
+    static_assert((capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+    
+    // Producer side. The reader drops whatever is queued the next time it
+    // pops, so only the reader ever moves the read index.
     void reset() noexcept
     {
-        value.store(0.0f);
+        resetPending.store(true, std::memory_order_release);
     }
     
-    void updateIfGreater(float newValue) noexcept
+    // Audio thread. Returns false and drops the frame if the reader is too far behind.
+    bool push(const Frame& frame) noexcept
     {
-        auto oldValue = value.load();
-        while (newValue > oldValue && !value.compare_exchange_weak(oldValue, newValue));
+        int write = writeIndex.load(std::memory_order_relaxed);
+        int next = (write + 1) & (capacity - 1);
+        if (next == readIndex.load(std::memory_order_acquire)) {
+            return false;
+        }
+        frames[size_t(write)] = frame;
+        writeIndex.store(next, std::memory_order_release);
+        return true;
     }
     
-    float readAndReset() noexcept
+    // Reader thread. Returns false when there is nothing left to read.
+    bool pop(Frame& frame) noexcept
+    {
+        if (resetPending.load(std::memory_order_relaxed) && resetPending.exchange(false, std::memory_order_acquire)) {
+            readIndex.store(writeIndex.load(std::memory_order_acquire), std::memory_order_release);
+        }
+        
+        int read = readIndex.load(std::memory_order_relaxed);
+        if (read == writeIndex.load(std::memory_order_acquire)) {
+            return false;
+        }
+        frame = frames[size_t(read)];
+        readIndex.store((read + 1) & (capacity - 1), std::memory_order_release);
+        return true;
+    }
+    
+    std::array<Frame, capacity> frames;
+    alignas(64) std::atomic<int> writeIndex { 0 };
+    alignas(64) std::atomic<int> readIndex { 0 };
+    std::atomic<bool> resetPending { false };
+};
+
+// The meter's reader drains as rarely as twice a second while the editor is
+// hidden, which is more blocks than fit when the host's blocks are small.
+// Frames that don't fit are merged into one that waits for the next push,
+// so a slow reader gets them late and coarser but never misses a peak.
+struct Measurement : FrameFifo<MeterFrame, 256>
+{
+    // Audio thread
+    void push(const MeterFrame& frame) noexcept
+    {
+        if (hasPending) {
+            pending.merge(frame);
+        } else {
+            pending = frame;
+            hasPending = true;
+        }
+        if (FrameFifo::push(pending)) {
+            hasPending = false;
+        }
+    }
+    
+    void reset() noexcept
     {
-        return value.exchange(0.0f);
+        hasPending = false;
+        FrameFifo::reset();
     }
     
-    std::atomic<float> value;
+private:
+    MeterFrame pending;
+    bool hasPending = false;
 };
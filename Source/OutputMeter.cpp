@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    OutputMeter.cpp
+    Created: 19 Oct 2026 5:21:16pm
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "OutputMeter.h"
+
+// ITU-R BS.1770-4 Annex 2, 48-tap interpolator split into 4 phases
+static constexpr float truePeakCoefs[4][12] =
+{
+    {  0.0017089843750f,  0.0109863281250f, -0.0196533203125f,  0.0332031250000f,
+      -0.0594482421875f,  0.1373291015625f,  0.9721679687500f, -0.1022949218750f,
+       0.0476074218750f, -0.0266113281250f,  0.0148925781250f, -0.0083007812500f },
+    { -0.0291748046875f,  0.0292968750000f, -0.0517578125000f,  0.0891113281250f,
+      -0.1665039062500f,  0.4650878906250f,  0.7797851562500f, -0.2003173828125f,
+       0.1015625000000f, -0.0582275390625f,  0.0330810546875f, -0.0189208984375f },
+    { -0.0189208984375f,  0.0330810546875f, -0.0582275390625f,  0.1015625000000f,
+      -0.2003173828125f,  0.7797851562500f,  0.4650878906250f, -0.1665039062500f,
+       0.0891113281250f, -0.0517578125000f,  0.0292968750000f, -0.0291748046875f },
+    { -0.0083007812500f,  0.0148925781250f, -0.0266113281250f,  0.0476074218750f,
+      -0.1022949218750f,  0.9721679687500f,  0.1373291015625f, -0.0594482421875f,
+       0.0332031250000f, -0.0196533203125f,  0.0109863281250f,  0.0017089843750f },
+};
+
+static float absolutePeak(const float* data, int numSamples) noexcept
+{
+    auto range = juce::FloatVectorOperations::findMinAndMax(data, numSamples);
+    return std::max(-range.getStart(), range.getEnd());
+}
+
+void OutputMeter::reset() noexcept
+{
+    for (int channel = 0; channel < 2; ++channel) {
+        for (int i = 0; i < historyLength; ++i) {
+            history[channel][i] = 0.0f;
+        }
+    }
+}
+
+MeterFrame OutputMeter::measure(int channel, const float* data, int numSamples) noexcept
+{
+    jassert(channel >= 0 && channel < 2);
+    
+    MeterFrame frame;
+    frame.numSamples = numSamples;
+    
+    // The previous samples followed by the current chunk, so every output of
+    // the interpolator can be computed without wrapping
+    float input[historyLength + chunkSize];
+    float* samples = input + historyLength;
+    float* state = history[channel];
+    
+    for (int offset = 0; offset < numSamples; offset += chunkSize) {
+        int blockSize = std::min(chunkSize, numSamples - offset);
+        
+        for (int i = 0; i < historyLength; ++i) {
+            input[i] = state[i];
+        }
+        for (int i = 0; i < blockSize; ++i) {
+            samples[i] = data[offset + i];
+        }
+        
+        float peak = absolutePeak(samples, blockSize);
+        
+        float sumOfSquares = 0.0f;
+        for (int i = 0; i < blockSize; ++i) {
+            sumOfSquares += samples[i] * samples[i];
+        }
+        
+        float truePeak = peak;
+        for (int phase = 0; phase < 4; ++phase) {
+            float interpolated[chunkSize];
+            for (int i = 0; i < blockSize; ++i) {
+                interpolated[i] = 0.0f;
+            }
+            for (int tap = 0; tap < numTaps; ++tap) {
+                const float coef = truePeakCoefs[phase][tap];
+                const float* x = samples - tap;
+                for (int i = 0; i < blockSize; ++i) {
+                    interpolated[i] += coef * x[i];
+                }
+            }
+            truePeak = std::max(truePeak, absolutePeak(interpolated, blockSize));
+        }
+        
+        frame.peak = std::max(frame.peak, peak);
+        frame.truePeak = std::max(frame.truePeak, truePeak);
+        frame.sumOfSquares += sumOfSquares;
+        
+        for (int i = 0; i < historyLength; ++i) {
+            state[i] = input[blockSize + i];
+        }
+    }
+    
+    frame.clipped = frame.peak > 1.0f;
+    return frame;
+}
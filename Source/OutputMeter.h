@@ -0,0 +1,32 @@
+/*
+  ==============================================================================
+
+    OutputMeter.h
+    Created: 19 Oct 2026 5:21:16pm
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "Measurement.h"
+
+// Measures a finished output block in one go: sample peak, sum of squares
+// and 4x oversampled true peak using the polyphase FIR from ITU-R BS.1770.
+// Keeping this out of the processing loop lets both be vectorized.
+class OutputMeter
+{
+public:
+    void reset() noexcept;
+    
+    // channel is 0 or 1; each keeps its own filter history
+    MeterFrame measure(int channel, const float* data, int numSamples) noexcept;
+    
+private:
+    static constexpr int numTaps = 12;                  // per phase
+    static constexpr int historyLength = numTaps - 1;
+    static constexpr int chunkSize = 256;
+    
+    float history[2][historyLength] = {};
+};
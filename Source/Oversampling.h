@@ -0,0 +1,365 @@
+/*
+  ==============================================================================
+
+    Oversampling.h
+    Created: 19 Oct 2026 9:12:40am
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+// Polyphase half-band IIR filter made of two chains of first-order allpasses,
+// one for the even and one for the odd output phase. A stereo pair is handled
+// as four lanes [L even, L odd, R even, R odd] of one SIMDRegister, so every
+// allpass step is a single SIMD multiply-add. Registers wider than four
+// lanes carry zeros in the rest.
+template<int numCoefs>
+class HalfBandFilter
+{
+public:
+    static_assert(numCoefs % 2 == 0, "coefficients are split between two chains");
+    
+    explicit HalfBandFilter(const std::array<float, numCoefs>& coefs) noexcept
+    {
+        for (int i = 0; i < numPairs; ++i) {
+            Lanes lanes {};
+            for (int lane = 0; lane < 4; lane += 2) {
+                lanes[lane] = coefs[size_t(i * 2)];
+                lanes[lane + 1] = coefs[size_t(i * 2 + 1)];
+            }
+            coef[i] = Vec::fromRawArray(lanes);
+        }
+        reset();
+    }
+    
+    void reset() noexcept
+    {
+        for (int i = 0; i < numPairs; ++i) {
+            x[i] = Vec::expand(0.0f);
+            y[i] = Vec::expand(0.0f);
+        }
+    }
+    
+    // One sample per channel in, two samples per channel out
+    void upsample(float inL, float inR, float* outL, float* outR) noexcept
+    {
+        Lanes v { inL, inL, inR, inR };
+        processLanes(v);
+        outL[0] = v[0];
+        outL[1] = v[1];
+        outR[0] = v[2];
+        outR[1] = v[3];
+    }
+    
+    // Two samples per channel in, one sample per channel out
+    void downsample(const float* inL, const float* inR, float& outL, float& outR) noexcept
+    {
+        Lanes v { inL[1], inL[0], inR[1], inR[0] };
+        processLanes(v);
+        outL = (v[0] + v[1]) * 0.5f;
+        outR = (v[2] + v[3]) * 0.5f;
+    }
+    
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static_assert(Vec::SIMDNumElements >= 4, "the four lanes have to fit into one register");
+    
+    struct alignas(Vec::SIMDRegisterSize) Lanes
+    {
+        float values[Vec::SIMDNumElements] {};
+        operator float*() noexcept { return values; }
+    };
+    
+    void processLanes(Lanes& lanes) noexcept
+    {
+        auto v = Vec::fromRawArray(lanes);
+        for (int i = 0; i < numPairs; ++i) {
+            auto temp = (v - y[i]) * coef[i] + x[i];
+            x[i] = v;
+            y[i] = temp;
+            v = temp;
+        }
+        v.copyToRawArray(lanes);
+    }
+    
+    static constexpr int numPairs = numCoefs / 2;
+    
+    Vec coef[numPairs];
+    Vec x[numPairs];
+    Vec y[numPairs];
+};
+
+// 2x / 4x oversampling around a per-sample stereo callback. The stage that
+// goes from 1x to 2x has a narrow transition band (0.04, about 99 dB of
+// rejection); the 2x to 4x stage only has to reject images far above the
+// signal so it gets by with half the allpasses. With a factor of 1 the
+// callback is called directly and nothing else runs.
+class Oversampler
+{
+public:
+    void reset() noexcept
+    {
+        up2.reset();
+        down2.reset();
+        up4.reset();
+        down4.reset();
+    }
+    
+    void setFactor(int newFactor) noexcept
+    {
+        if (newFactor != factor) {
+            factor = newFactor;
+            reset();
+        }
+    }
+    
+    int getFactor() const noexcept
+    {
+        return factor;
+    }
+    
+    // Delay of the way up and back down at low frequencies, in samples at
+    // the base rate. Higher up the allpasses delay more, so this is what a
+    // caller can compensate for, not the whole phase response.
+    float getLatency() const noexcept
+    {
+        if (factor == 1) { return 0.0f; }
+        
+        float latency = chainDelay(coefs2x);
+        if (factor == 4) {
+            latency += chainDelay(coefs4x) * 0.5f;
+        }
+        return latency;
+    }
+    
+    template<typename Callback>
+    void process(float& left, float& right, Callback&& callback) noexcept
+    {
+        if (factor == 1) {
+            callback(left, right);
+            return;
+        }
+        
+        float left2[2], right2[2];
+        up2.upsample(left, right, left2, right2);
+        
+        for (int i = 0; i < 2; ++i) {
+            if (factor == 2) {
+                callback(left2[i], right2[i]);
+            } else {
+                float left4[2], right4[2];
+                up4.upsample(left2[i], right2[i], left4, right4);
+                callback(left4[0], right4[0]);
+                callback(left4[1], right4[1]);
+                down4.downsample(left4, right4, left2[i], right2[i]);
+            }
+        }
+        
+        down2.downsample(left2, right2, left, right);
+    }
+    
+private:
+    static constexpr std::array<float, 8> coefs2x = {
+        0.040633461f, 0.150505129f, 0.300757056f, 0.460774505f,
+        0.609524315f, 0.738503841f, 0.849223810f, 0.949742784f,
+    };
+    
+    static constexpr std::array<float, 4> coefs4x = {
+        0.042454710f, 0.170739850f, 0.393319893f, 0.745713589f,
+    };
+    
+    // An allpass (a + z^-1) / (1 + a z^-1) delays DC by (1 - a) / (1 + a)
+    // samples. Every sample passes one chain on the way up and the other
+    // on the way down, so the stage delays by the sum over all of them.
+    template<size_t numCoefs>
+    static constexpr float chainDelay(const std::array<float, numCoefs>& coefs) noexcept
+    {
+        float delay = 0.0f;
+        for (float a : coefs) {
+            delay += (1.0f - a) / (1.0f + a);
+        }
+        return delay;
+    }
+    
+    HalfBandFilter<8> up2 { coefs2x };
+    HalfBandFilter<8> down2 { coefs2x };
+    HalfBandFilter<4> up4 { coefs4x };
+    HalfBandFilter<4> down4 { coefs4x };
+    
+    int factor = 1;
+};
+
+// Linear-phase half-band FIR, a Kaiser-windowed sinc with halfLength taps on
+// either side of the centre. Delays every frequency equally, so unlike the
+// allpass version its delay can be compensated exactly. It costs several
+// times as much, which is why only offline rendering uses it.
+template<int halfLength>
+class LinearPhaseHalfBand
+{
+public:
+    explicit LinearPhaseHalfBand(float beta) noexcept
+    {
+        // Only the odd taps of a half-band are non-zero, and they must add up
+        // to 0.5 for unity gain at DC
+        float sum = 0.0f;
+        for (int i = 0; i < numTaps; ++i) {
+            float k = float(2 * i - (numTaps - 1));
+            float x = 0.5f * 3.14159265358979f * k;
+            float window = besselI0(beta * std::sqrt(1.0f - (k * k) / float(numTaps * numTaps))) / besselI0(beta);
+            taps[i] = std::sin(x) / x * 0.5f * window;
+            sum += taps[i];
+        }
+        for (int i = 0; i < numTaps; ++i) {
+            taps[i] *= 0.5f / sum;
+        }
+        reset();
+    }
+    
+    void reset() noexcept
+    {
+        for (int ch = 0; ch < 2; ++ch) {
+            for (int i = 0; i < 2 * numTaps; ++i) {
+                upHistory[ch][i] = 0.0f;
+                oddHistory[ch][i] = 0.0f;
+                evenHistory[ch][i] = 0.0f;
+            }
+        }
+        upIndex = 0;
+        downIndex = 0;
+    }
+    
+    void upsample(float inL, float inR, float* outL, float* outR) noexcept
+    {
+        upIndex = push(upHistory, upIndex, inL, inR);
+        outL[0] = 2.0f * convolve(upHistory[0] + upIndex);
+        outR[0] = 2.0f * convolve(upHistory[1] + upIndex);
+        outL[1] = upHistory[0][upIndex + halfLength - 1];
+        outR[1] = upHistory[1][upIndex + halfLength - 1];
+    }
+    
+    void downsample(const float* inL, const float* inR, float& outL, float& outR) noexcept
+    {
+        push(evenHistory, downIndex, inL[0], inR[0]);
+        downIndex = push(oddHistory, downIndex, inL[1], inR[1]);
+        outL = 0.5f * evenHistory[0][downIndex + halfLength - 1] + convolve(oddHistory[0] + downIndex);
+        outR = 0.5f * evenHistory[1][downIndex + halfLength - 1] + convolve(oddHistory[1] + downIndex);
+    }
+    
+    // Delay of upsample followed by downsample, in samples at the lower rate
+    static constexpr float latency = 2.0f * halfLength - 1.5f;
+    
+private:
+    static constexpr int numTaps = 2 * halfLength;
+    
+    // The histories are stored twice over, so the newest numTaps values are
+    // always in one piece starting at the index, newest first
+    static int push(float (&history)[2][2 * numTaps], int index, float left, float right) noexcept
+    {
+        index = index == 0 ? numTaps - 1 : index - 1;
+        history[0][index] = history[0][index + numTaps] = left;
+        history[1][index] = history[1][index + numTaps] = right;
+        return index;
+    }
+    
+    float convolve(const float* history) const noexcept
+    {
+        float sum = 0.0f;
+        for (int i = 0; i < numTaps; ++i) {
+            sum += taps[i] * history[i];
+        }
+        return sum;
+    }
+    
+    static float besselI0(float x) noexcept
+    {
+        float sum = 1.0f;
+        float term = 1.0f;
+        for (int k = 1; k < 20; ++k) {
+            term *= (0.5f * x / float(k)) * (0.5f * x / float(k));
+            sum += term;
+        }
+        return sum;
+    }
+    
+    float taps[numTaps];
+    float upHistory[2][2 * numTaps];
+    float oddHistory[2][2 * numTaps];
+    float evenHistory[2][2 * numTaps];
+    int upIndex = 0;
+    int downIndex = 0;
+};
+
+// The same job as Oversampler with linear-phase filters: about 100 dB of
+// image rejection from the 1x to 2x stage, less from 2x to 4x, which only
+// has to keep images away from the signal.
+class LinearPhaseOversampler
+{
+public:
+    void reset() noexcept
+    {
+        stage2.reset();
+        stage4.reset();
+    }
+    
+    void setFactor(int newFactor) noexcept
+    {
+        if (newFactor != factor) {
+            factor = newFactor;
+            reset();
+        }
+    }
+    
+    int getFactor() const noexcept
+    {
+        return factor;
+    }
+    
+    // In samples at the base rate, the same at every frequency
+    float getLatency() const noexcept
+    {
+        if (factor == 1) { return 0.0f; }
+        return factor == 2 ? Stage2::latency : Stage2::latency + Stage4::latency * 0.5f;
+    }
+    
+    template<typename Callback>
+    void process(float& left, float& right, Callback&& callback) noexcept
+    {
+        if (factor == 1) {
+            callback(left, right);
+            return;
+        }
+        
+        float left2[2], right2[2];
+        stage2.upsample(left, right, left2, right2);
+        
+        for (int i = 0; i < 2; ++i) {
+            if (factor == 2) {
+                callback(left2[i], right2[i]);
+            } else {
+                float left4[2], right4[2];
+                stage4.upsample(left2[i], right2[i], left4, right4);
+                callback(left4[0], right4[0]);
+                callback(left4[1], right4[1]);
+                stage4.downsample(left4, right4, left2[i], right2[i]);
+            }
+        }
+        
+        stage2.downsample(left2, right2, left, right);
+    }
+    
+private:
+    using Stage2 = LinearPhaseHalfBand<16>;
+    using Stage4 = LinearPhaseHalfBand<6>;
+    
+    Stage2 stage2 { 10.0f };
+    Stage4 stage4 { 7.0f };
+    
+    int factor = 1;
+};
@@ -0,0 +1,40 @@
+/*
+  ==============================================================================
+
+    ParameterNotifier.cpp
+    Created: 20 Oct 2026 10:14:33am
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#include "ParameterNotifier.h"
+
+ParameterNotifier::~ParameterNotifier()
+{
+    for (auto& entry : entries) {
+        entry->parameter.removeListener(entry.get());
+    }
+}
+
+void ParameterNotifier::add(juce::AudioProcessorParameter& parameter, std::function<void()> callback)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    jassert(entries.size() < size_t(maxParameters));
+    
+    std::uint64_t mask = std::uint64_t(1) << entries.size();
+    entries.push_back(std::make_unique<Entry>(dirty, parameter, mask, std::move(callback)));
+    parameter.addListener(entries.back().get());
+}
+
+void ParameterNotifier::deliver()
+{
+    auto changed = dirty.exchange(0, std::memory_order_acquire);
+    if (changed == 0) { return; }
+    
+    for (auto& entry : entries) {
+        if ((changed & entry->mask) != 0) {
+            entry->callback();
+        }
+    }
+}
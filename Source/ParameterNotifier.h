@@ -0,0 +1,57 @@
+/*
+  ==============================================================================
+
+    ParameterNotifier.h
+    Created: 20 Oct 2026 10:14:33am
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Delivers parameter changes to the UI without posting a message for every
+    change. A change from any thread, the audio thread included, only sets
+    the parameter's bit in an atomic mask. The owner calls deliver() once
+    per frame, which collects the bits and runs each callback at most once.
+*/
+class ParameterNotifier
+{
+public:
+    ParameterNotifier() = default;
+    ~ParameterNotifier();
+    
+    // Message thread only
+    void add(juce::AudioProcessorParameter& parameter, std::function<void()> callback);
+    void deliver();
+
+private:
+    struct Entry : public juce::AudioProcessorParameter::Listener
+    {
+        Entry(std::atomic<std::uint64_t>& dirty_, juce::AudioProcessorParameter& parameter_, std::uint64_t mask_, std::function<void()> callback_)
+            : dirty(dirty_), parameter(parameter_), mask(mask_), callback(std::move(callback_)) { }
+        
+        void parameterValueChanged(int, float) override
+        {
+            dirty.fetch_or(mask, std::memory_order_release);
+        }
+        
+        void parameterGestureChanged(int, bool) override { }
+        
+        std::atomic<std::uint64_t>& dirty;
+        juce::AudioProcessorParameter& parameter;
+        const std::uint64_t mask;
+        std::function<void()> callback;
+    };
+    
+    static constexpr int maxParameters = 64;
+    
+    std::atomic<std::uint64_t> dirty { 0 };
+    std::vector<std::unique_ptr<Entry>> entries;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParameterNotifier)
+};
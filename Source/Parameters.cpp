@@ -9,7 +9,6 @@
 */
 
 #include "Parameters.h"
-#include "DSP.h"
 
 template<typename T>
 static void castParameter(juce::AudioProcessorValueTreeState& apvts,const juce::ParameterID& id, T& destination)
@@ -74,6 +73,12 @@ static float hzFromString(const juce::String& str)
     return value;
 }
 
+// 0 - 100 % drive maps to 0 - 24 dB of gain into the saturator
+static float driveGainFromPercent(float percent)
+{
+    return juce::Decibels::decibelsToGain(percent * 0.24f);
+}
+
 Parameters::Parameters(juce::AudioProcessorValueTreeState& apvts)
 {
     castParameter(apvts, gainParamID, gainParam);
@@ -86,6 +91,9 @@ Parameters::Parameters(juce::AudioProcessorValueTreeState& apvts)
     castParameter(apvts, tempoSyncParamID, tempoSyncParam);
     castParameter(apvts, delayNoteParamID, delayNoteParam);
     castParameter(apvts, bypassParamID, bypassParam);
+    castParameter(apvts, driveParamID, driveParam);
+    castParameter(apvts, oversamplingParamID, oversamplingParam);
+    castParameter(apvts, diffuseParamID, diffuseParam);
 }
 
 //===============================================================================
@@ -174,89 +182,47 @@ juce::AudioProcessorValueTreeState::ParameterLayout Parameters::createParameterL
     
     layout.add(std::make_unique<juce::AudioParameterBool>(bypassParamID, "Bypass", false));
     
-    return layout;
-}
-
-void Parameters::prepareToPlay(double sampleRate) noexcept
-{
-    double duration = 0.02;
-    gainSmoother.reset(sampleRate, duration);
-    
-    coeff = 1.0f - std::exp(-1.0f / (0.2f * float(sampleRate)));
-    
-    mixSmoother.reset(sampleRate, duration);
-    
-    feedbackSmoother.reset(sampleRate, duration);
-    
-    stereoSmoother.reset(sampleRate, duration);
-    
-    lowCutSmoother.reset(sampleRate, duration);
-    highCutSmoother.reset(sampleRate, duration);
-}
-
-void Parameters::reset() noexcept
-{
-    gain = 0.0f;
-    gainSmoother.setCurrentAndTargetValue(juce::Decibels::decibelsToGain(gainParam->get()));
-    
-    delayTime = 0.0f;
-    
-    mix = 1.0f;
-    mixSmoother.setCurrentAndTargetValue(mixParam->get() * 0.01f);
-    
-    feedback = 0.0f;
-    feedbackSmoother.setTargetValue(feedbackParam->get() * 0.01f);
-    
-    panL = 0.0f;
-    panR = 1.0f;
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+                                                          driveParamID,
+                                                          "Drive",
+                                                          juce::NormalisableRange<float>(0.0f, 100.0f, 1.0f),
+                                                          0.0f,
+                                                          juce::AudioParameterFloatAttributes().withStringFromValueFunction(stringFromPercent)
+                                                          ));
     
-    stereoSmoother.setCurrentAndTargetValue(stereoParam->get() * 0.1f);
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+                                                            oversamplingParamID,
+                                                            "Oversampling",
+                                                            juce::StringArray { "Off", "2x", "4x" },
+                                                            0,
+                                                            juce::AudioParameterChoiceAttributes().withAutomatable(false)
+                                                            ));
     
-    lowCut = 20.0f;
-    lowCutSmoother.setCurrentAndTargetValue(highCutParam->get());
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+                                                          diffuseParamID,
+                                                          "Diffuse",
+                                                          juce::NormalisableRange<float>(0.0f, 100.0f, 1.0f),
+                                                          0.0f,
+                                                          juce::AudioParameterFloatAttributes().withStringFromValueFunction(stringFromPercent)
+                                                          ));
     
-    highCut = 20000.0f;
-    highCutSmoother.setCurrentAndTargetValue(highCutParam->get());
+    return layout;
 }
 
 void Parameters::update() noexcept
 {
-    gainSmoother.setTargetValue(juce::Decibels::decibelsToGain(gainParam->get()));
-    targetDelayTime = delayTimeParam->get();
-    if (delayTime == 0.0f)
-        delayTime = targetDelayTime;
-    
-    mixSmoother.setTargetValue(mixParam->get() * 0.01f);
-    
-    feedbackSmoother.setTargetValue(feedbackParam->get() * 0.01f);
-    
-    stereoSmoother.setTargetValue(stereoParam->get() * 0.01f);
-    
-    lowCutSmoother.setTargetValue(lowCutParam->get());
-    highCutSmoother.setTargetValue(highCutParam->get());
+    values.gain = juce::Decibels::decibelsToGain(gainParam->get());
+    values.delayTime = delayTimeParam->get();
+    values.mix = mixParam->get() * 0.01f;
+    values.feedback = feedbackParam->get() * 0.01f;
+    values.stereo = stereoParam->get() * 0.01f;
+    values.lowCut = lowCutParam->get();
+    values.highCut = highCutParam->get();
+    values.drive = driveGainFromPercent(driveParam->get());
+    values.diffuse = diffuseParam->get() * 0.01f;
+    values.oversampling = 1 << oversamplingParam->getIndex();
+    values.bypassed = bypassParam->get();
     
     delayNote = delayNoteParam->getIndex();
     tempoSync = tempoSyncParam->get();
-    
-    bypassed = bypassParam->get();
-}
-
-void Parameters::smoothen() noexcept
-{
-    gain = gainSmoother.getNextValue();
-    
-    // No crossfade
-    //delayTime += (targetDelayTime - delayTime) * coeff;
-    
-    // Crossfade
-    //delayTime = targetDelayTime;
-    
-    // Ducking
-    delayTime = targetDelayTime;
-    
-    mix = mixSmoother.getNextValue();
-    feedback = feedbackSmoother.getNextValue();
-    panningEqualPower(stereoSmoother.getNextValue(), panL, panR);
-    lowCut = lowCutSmoother.getNextValue();
-    highCut = highCutSmoother.getNextValue();
 }
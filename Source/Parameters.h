@@ -11,6 +11,8 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "DelayEngine.h"
+
 const juce::ParameterID gainParamID { "gain", 1};
 const juce::ParameterID delayTimeParamID { "delayTime", 1};
 const juce::ParameterID mixParamID { "mix", 1 };
@@ -21,7 +23,12 @@ const juce::ParameterID lowCutParamID { "highCut", 1};
 const juce::ParameterID tempoSyncParamID { "tempoSync", 1 };
 const juce::ParameterID delayNoteParamID { "delayNote", 1 };
 const juce::ParameterID bypassParamID { "bypass", 1 };
+const juce::ParameterID driveParamID { "drive", 1 };
+const juce::ParameterID oversamplingParamID { "oversampling", 1 };
+const juce::ParameterID diffuseParamID { "diffuse", 1 };
 
+// Reads the plug-in parameters once per block into the snapshot the engine
+// wants, converting them to the units the DSP works in on the way
 class Parameters
 {
 public:
@@ -30,52 +37,30 @@ public:
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
     
     void update() noexcept;
-    void prepareToPlay(double sampleRate) noexcept;
-    void reset() noexcept;
-    void smoothen() noexcept;
-    
-    float gain = 0.0f;
     
     static constexpr float minDelayTime = 5.0f;
-    static constexpr float maxDelayTime = 5000.0f;
-    
-    float delayTime = 0.0f;
-    
-    float mix = 1.0f;
-    
-    float feedback = 0.0f;
+    static constexpr float maxDelayTime = DelayEngine::maxDelayTime;
     
-    float panL = 0.0f;
-    float panR = 1.0f;
-    
-    float lowCut = 20.0f;
-    float highCut = 20000.0f;
+    // The delay time in here is the free-running one, the processor swaps in
+    // the synced time when tempoSync is on
+    DelayParameters values;
     
     int delayNote = 0;
     bool tempoSync = false;
     juce::AudioParameterBool* tempoSyncParam;
     
-    bool bypassed = false;
     juce::AudioParameterBool* bypassParam;
     
 private:
     juce::AudioParameterFloat* gainParam;
-    juce::LinearSmoothedValue<float> gainSmoother;
     juce::AudioParameterFloat* delayTimeParam;
     juce::AudioParameterFloat* mixParam;
-    juce::LinearSmoothedValue<float> mixSmoother;
     juce::AudioParameterFloat* feedbackParam;
-    juce::LinearSmoothedValue<float> feedbackSmoother;
     juce::AudioParameterFloat* stereoParam;
-    juce::LinearSmoothedValue<float> stereoSmoother;
     juce::AudioParameterFloat* lowCutParam;
-    juce::LinearSmoothedValue<float> lowCutSmoother;
     juce::AudioParameterFloat* highCutParam;
-    juce::LinearSmoothedValue<float> highCutSmoother;
     juce::AudioParameterChoice* delayNoteParam;
-    
-    
-    float targetDelayTime = 0.0f;
-    float coeff = 0.0f; // one-pole smooting
+    juce::AudioParameterFloat* driveParam;
+    juce::AudioParameterChoice* oversamplingParam;
+    juce::AudioParameterFloat* diffuseParam;
 };
-
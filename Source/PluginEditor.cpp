@@ -11,7 +11,7 @@
 
 //==============================================================================
 DddelayyyAudioProcessorEditor::DddelayyyAudioProcessorEditor (DddelayyyAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p), meter (p.levelL, p.levelR)
+    : AudioProcessorEditor (&p), audioProcessor (p), meter (p.levelL, p.levelR), loudnessDisplay (p.loudness)
 {
     delayGroup.setText("Delay");
     delayGroup.setTextLabelPosition(juce::Justification::horizontallyCentred);
@@ -25,6 +25,8 @@ DddelayyyAudioProcessorEditor::DddelayyyAudioProcessorEditor (DddelayyyAudioProc
     feedbackGroup.addAndMakeVisible(stereoKnob);
     feedbackGroup.addAndMakeVisible(lowCutKnob);
     feedbackGroup.addAndMakeVisible(highCutKnob);
+    feedbackGroup.addAndMakeVisible(driveKnob);
+    feedbackGroup.addAndMakeVisible(diffuseKnob);
     addAndMakeVisible(feedbackGroup);
     
     outputGroup.setText("Output");
@@ -41,6 +43,17 @@ DddelayyyAudioProcessorEditor::DddelayyyAudioProcessorEditor (DddelayyyAudioProc
     tempoSyncButton.setLookAndFeel(ButtonLookAndFeel::get());
     delayGroup.addAndMakeVisible(tempoSyncButton);
     
+    oversamplingBox.addItemList(audioProcessor.params.oversamplingParam->choices, 1);
+    oversamplingBox.setSize(70, 27);
+    oversamplingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.apvts, oversamplingParamID.getParamID(), oversamplingBox);
+    delayGroup.addAndMakeVisible(oversamplingBox);
+    
+    oversamplingLabel.setText("Oversampling", juce::NotificationType::dontSendNotification);
+    oversamplingLabel.setJustificationType(juce::Justification::horizontallyCentred);
+    oversamplingLabel.attachToComponent(&oversamplingBox, false);
+    delayGroup.addAndMakeVisible(oversamplingLabel);
+    
     auto bypassIcon = juce::ImageCache::getFromMemory(BinaryData::Bypass_png, BinaryData::Bypass_pngSize);
     
     bypassButton.setClickingTogglesState(true);
@@ -52,23 +65,51 @@ DddelayyyAudioProcessorEditor::DddelayyyAudioProcessorEditor (DddelayyyAudioProc
                            0.0f);
     addAndMakeVisible(bypassButton);
     
-    setSize (500, 330);
+    addAndMakeVisible(loudnessDisplay);
+    
+   #if DDDELAYYY_PROFILING
+    addAndMakeVisible(profilerOverlay);
+   #endif
+    
+    setOpaque(true);
+    setSize (590, 330);
     
     setLookAndFeel(&mainLF);
     
     updateDelayKnobs(audioProcessor.params.tempoSyncParam->get());
-    audioProcessor.params.tempoSyncParam->addListener(this);
+    parameterNotifier.add(*audioProcessor.params.tempoSyncParam, [this]
+    {
+        updateDelayKnobs(audioProcessor.params.tempoSyncParam->get());
+    });
 }
 
 DddelayyyAudioProcessorEditor::~DddelayyyAudioProcessorEditor()
 {
-    audioProcessor.params.tempoSyncParam->removeListener(this);
     setLookAndFeel(nullptr);
 }
 
 //==============================================================================
 void DddelayyyAudioProcessorEditor::paint (juce::Graphics& g)
 {
+    float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (!background.isValid() || scale != backgroundScale) {
+        renderBackground(scale);
+    }
+    
+    g.drawImage(background, getLocalBounds().toFloat());
+}
+
+void DddelayyyAudioProcessorEditor::renderBackground(float scale)
+{
+    background = juce::Image(juce::Image::RGB,
+                             juce::roundToInt(float(getWidth()) * scale),
+                             juce::roundToInt(float(getHeight()) * scale),
+                             false);
+    backgroundScale = scale;
+    
+    juce::Graphics g(background);
+    g.addTransform(juce::AffineTransform::scale(scale));
+    
     //g.fillAll (Colors::background);
     auto noise = juce::ImageCache::getFromMemory(BinaryData::Noise_png, BinaryData::Noise_pngSize);
     auto fillType = juce::FillType(noise, juce::AffineTransform::scale(0.5f));
@@ -90,6 +131,8 @@ void DddelayyyAudioProcessorEditor::resized()
 {
     auto bounds = getLocalBounds();
     
+    background = {};    // rendered again on the next paint
+    
     int y = 50;
     int height = bounds.getHeight() - 60;
     
@@ -103,6 +146,7 @@ void DddelayyyAudioProcessorEditor::resized()
     // Position the knobs inside the groups
     delayTimeKnob.setTopLeftPosition(20, 20);
     tempoSyncButton.setTopLeftPosition(20, delayTimeKnob.getBottom() + 10);
+    oversamplingBox.setTopLeftPosition(20, tempoSyncButton.getBottom() + 34);
     delayNoteKnob.setTopLeftPosition(delayTimeKnob.getX(), delayTimeKnob.getY());
     mixKnob.setTopLeftPosition(20, 20);
     gainKnob.setTopLeftPosition(mixKnob.getX(), mixKnob.getBottom() + 10);
@@ -110,24 +154,21 @@ void DddelayyyAudioProcessorEditor::resized()
     stereoKnob.setTopLeftPosition(feedbackKnob.getRight() + 20, 20);
     lowCutKnob.setTopLeftPosition(feedbackKnob.getX(), feedbackKnob.getBottom() + 10);
     highCutKnob.setTopLeftPosition(lowCutKnob.getRight() + 20, lowCutKnob.getY());
+    driveKnob.setTopLeftPosition(stereoKnob.getRight() + 20, 20);
+    diffuseKnob.setTopLeftPosition(highCutKnob.getRight() + 20, lowCutKnob.getY());
     
     // Levelmeter
     meter.setBounds(outputGroup.getWidth() - 45, 30, 30, gainKnob.getBottom() - 30);
     
     // Bypass Button
     bypassButton.setTopLeftPosition(bounds.getRight() - bypassButton.getWidth() - 10, 10);
-}
-
-void DddelayyyAudioProcessorEditor::parameterValueChanged(int, float value)
-{
-    if (juce::MessageManager::getInstance()->isThisTheMessageThread()) {
-        updateDelayKnobs(value != 0.0f);
-    } else {
-        juce::MessageManager::callAsync([this, value]
-        {
-            updateDelayKnobs(value != 0.0f);
-        });
-    }
+    
+    // Loudness readout on the left of the header
+    loudnessDisplay.setBounds(10, 10, 180, 20);
+    
+   #if DDDELAYYY_PROFILING
+    profilerOverlay.setBounds(bounds);
+   #endif
 }
 
 void DddelayyyAudioProcessorEditor::updateDelayKnobs(bool tempoSyncActive)
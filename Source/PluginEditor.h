@@ -14,11 +14,14 @@
 #include "RotaryKnob.h"
 #include "LookAndFeel.h"
 #include "LevelMeter.h"
+#include "LoudnessDisplay.h"
+#include "ParameterNotifier.h"
+#include "ProfilerOverlay.h"
 
 //==============================================================================
 /**
 */
-class DddelayyyAudioProcessorEditor  : public juce::AudioProcessorEditor, private juce::AudioProcessorParameter::Listener
+class DddelayyyAudioProcessorEditor  : public juce::AudioProcessorEditor
 {
 public:
     DddelayyyAudioProcessorEditor (DddelayyyAudioProcessor&);
@@ -29,11 +32,13 @@ public:
     void resized() override;
 
 private:
-    void parameterValueChanged(int, float) override;
+    void updateDelayKnobs(bool tempoSyncActive);
     
-    void parameterGestureChanged(int, bool) override { }
+    // Noise texture, header and logo, composited once per size and scale
+    juce::Image background;
+    float backgroundScale = 0.0f;
     
-    void updateDelayKnobs(bool tempoSyncActive);
+    void renderBackground(float scale);
     
     DddelayyyAudioProcessor& audioProcessor;
     RotaryKnob gainKnob { "Gain", audioProcessor.apvts, gainParamID, true };
@@ -44,19 +49,38 @@ private:
     RotaryKnob lowCutKnob { "Low Cut", audioProcessor.apvts, lowCutParamID };
     RotaryKnob highCutKnob { "High Cut", audioProcessor.apvts, highCutParamID };
     RotaryKnob delayNoteKnob { "Note", audioProcessor.apvts, delayNoteParamID };
+    RotaryKnob driveKnob { "Drive", audioProcessor.apvts, driveParamID };
+    RotaryKnob diffuseKnob { "Diffuse", audioProcessor.apvts, diffuseParamID };
     
     juce::TextButton tempoSyncButton;
     
     juce::AudioProcessorValueTreeState::ButtonAttachment tempoSyncAttachment { audioProcessor.apvts, tempoSyncParamID.getParamID(), tempoSyncButton };
     
+    // Per instance and not automatable. The attachment is made once the
+    // box has its items, otherwise it can't show the current choice.
+    juce::ComboBox oversamplingBox;
+    juce::Label oversamplingLabel;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> oversamplingAttachment;
+    
     juce::GroupComponent delayGroup, feedbackGroup, outputGroup;
     MainLookAndFeel mainLF;
     
     LevelMeter meter;
     
+    LoudnessDisplay loudnessDisplay;
+    
     juce::ImageButton bypassButton;
     
     juce::AudioProcessorValueTreeState::ButtonAttachment bypassAttachment { audioProcessor.apvts, bypassParamID.getParamID(), bypassButton };
     
+    ParameterNotifier parameterNotifier;
+    
+    // Parameter changes reach the UI once per frame, and only while it is on screen
+    juce::VBlankAttachment vblankAttachment { this, [this] { parameterNotifier.deliver(); } };
+    
+   #if DDDELAYYY_PROFILING
+    ProfilerOverlay profilerOverlay { audioProcessor.profiler };
+   #endif
+    
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DddelayyyAudioProcessorEditor)
 };
@@ -16,14 +16,30 @@ DddelayyyAudioProcessor::DddelayyyAudioProcessor()
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                        ),
-params(apvts)
+params(apvts),
+stateFormat(*this),
+presets(stateFormat)
 {
-    lowCutFilter.setType(juce::dsp::StateVariableTPTFilterType::highpass);
-    highCutFilter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
 }
 
 DddelayyyAudioProcessor::~DddelayyyAudioProcessor()
 {
+    stopTimer();
+}
+
+void DddelayyyAudioProcessor::loadPresets()
+{
+    std::call_once(presetsLoaded, [this] { presets.load(PresetBank::getDefaultFile()); });
+}
+
+void DddelayyyAudioProcessor::timerCallback()
+{
+    loudness.update();
+    
+    int index = programToNotify.exchange(-1);
+    if (index >= 0) {
+        stateFormat.notify(presets.getSnapshot(index));
+    }
 }
 
 //==============================================================================
@@ -66,85 +82,124 @@ double DddelayyyAudioProcessor::getTailLengthSeconds() const
 
 int DddelayyyAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
+    loadPresets();
+    return presets.size();  // NB: some hosts don't cope very well if you tell them there are 0 programs,
+                            // the factory bank always has at least one.
 }
 
 int DddelayyyAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentProgram.load();
 }
 
-void DddelayyyAudioProcessor::setCurrentProgram ([[maybe_unused]] int index)
+void DddelayyyAudioProcessor::setCurrentProgram (int index)
 {
+    loadPresets();
+    
+    if (index < 0 || index >= presets.size()) { return; }
+    
+    // Some hosts select the program they saved right after restoring a
+    // session. The restored state wins, the index is only taken over.
+    if (restoringState.exchange(false)) {
+        currentProgram.store(index);
+        return;
+    }
+    
+    currentProgram.store(index);
+    
+    if (prepared.load()) {
+        pendingProgram.store(index);
+    } else {
+        stateFormat.apply(presets.getSnapshot(index));
+    }
 }
 
-const juce::String DddelayyyAudioProcessor::getProgramName ([[maybe_unused]] int index)
+const juce::String DddelayyyAudioProcessor::getProgramName (int index)
 {
-    return {};
+    loadPresets();
+    return presets.getName(index);
 }
 
 void DddelayyyAudioProcessor::changeProgramName ([[maybe_unused]] int index, [[maybe_unused]] const juce::String& newName)
 {
+    // The bank is read-only
+}
+
+void DddelayyyAudioProcessor::updateProgram() noexcept
+{
+    // Once audio runs again a restore is over
+    if (restoringState.load(std::memory_order_relaxed)) {
+        restoringState.store(false, std::memory_order_relaxed);
+    }
+    
+    // A restored state must not be overwritten by a switch that began before it
+    if (programSwitchCancelled.exchange(false)) {
+        switchingProgram = -1;
+    }
+    
+    int index = pendingProgram.exchange(-1);
+    if (index >= 0) {
+        switchingProgram = index;
+    }
+    
+    // The wet signal is silent now, so the jump in settings can't be heard.
+    // params.update() picks the new values up right after this.
+    if (switchingProgram >= 0 && engine.isWetMuted()) {
+        stateFormat.store(presets.getSnapshot(switchingProgram));
+        programToNotify.store(switchingProgram);
+        switchingProgram = -1;
+    }
 }
 
 //==============================================================================
 void DddelayyyAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    params.prepareToPlay(sampleRate);
-    params.reset();
+    if (programSwitchCancelled.exchange(false)) {
+        switchingProgram = -1;
+    }
+    
+    // Nothing is playing, so a program change that was still fading can land now
+    if (switchingProgram >= 0) {
+        stateFormat.apply(presets.getSnapshot(switchingProgram));
+        switchingProgram = -1;
+    }
     
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = sampleRate;
     spec.maximumBlockSize = juce::uint32(samplesPerBlock);
-    spec.numChannels = 2;
-    
-    //delayLine.prepare(spec);
+    spec.numChannels = juce::uint32(getMainBusNumOutputChannels());
     
-    double numSamples = (Parameters::maxDelayTime / 1000.0) * sampleRate;
-    int maxDelayInSamples = int(std::ceil(numSamples));
-    //delayLine.setMaximumDelayInSamples(maxDelayInSamples);
-    //delayLine.reset();
-    
-    delayLineL.setMaximumDelayInSamples(maxDelayInSamples);
-    delayLineR.setMaximumDelayInSamples(maxDelayInSamples);
-    delayLineL.reset();
-    delayLineR.reset();
-    
-    feedbackL = 0.0f;
-    feedbackR = 0.0f;
-    
-    lowCutFilter.prepare(spec);
-    lowCutFilter.reset();
+    params.update();
+    auto parameters = params.values;
+    parameters.highQuality = isNonRealtime();
     
-    highCutFilter.prepare(spec);
-    highCutFilter.reset();
+    engine.prepare(spec);
+    engine.reset(parameters);
+    prepared.store(true);
     
     tempo.reset();
     
     levelL.reset();
     levelR.reset();
+    outputMeter.reset();
+    loudness.prepare(sampleRate);
     
-    //delayInSamples = 0.0f;                                      // Crossfade
-    //targetDelay = 0.0f;                                         // Crossfade
-    //xfade = 0.0f;                                               // Crossfade
-    //xfadeInc = static_cast<float>(1.0 / (0.5 * sampleRate));    // Crossfade 50 ms
-    
-    delayInSamples = 0.0f;
-    targetDelay = 0.0f;
-    fade = 1.0f;
-    fadeTarget = 1.0f;
-    coeff = 1.0f - std::exp(-1.0f / (0.05f * float(sampleRate)));
-    wait = 0.0f;
-    waitInc = 1.0f / (0.3f * float(sampleRate));
+   #if DDDELAYYY_PROFILING
+    profiler.prepare(sampleRate);
+   #endif
     
-    //DBG(maxDelayInSamples);
+    startTimerHz(10);
 }
 
 void DddelayyyAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    prepared.store(false);
+    
+    // A program change from the last block would otherwise never be announced
+    stopTimer();
+    timerCallback();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -165,6 +220,8 @@ bool DddelayyyAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts
 
 void DddelayyyAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, [[maybe_unused]]juce::MidiBuffer& midiMessages)
 {
+    DDDELAYYY_PROFILE_BEGIN(profiler);
+    
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -172,7 +229,9 @@ void DddelayyyAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, [[
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
     
+    updateProgram();
     params.update();
+    DDDELAYYY_PROFILE_LAP(profiler, parameters);
     
     tempo.update(getPlayHead());
     
@@ -180,163 +239,43 @@ void DddelayyyAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, [[
     if( syncedTime > Parameters::maxDelayTime) {
         syncedTime = Parameters::maxDelayTime;
     }
+    DDDELAYYY_PROFILE_LAP(profiler, tempo);
+    
+    auto parameters = params.values;
+    if (params.tempoSync) {
+        parameters.delayTime = syncedTime;
+    }
+    parameters.muted = switchingProgram >= 0;
     
-    float sampleRate = float(getSampleRate());
+    // Offline bounces get the costlier kernels, the engine crossfades to them
+    parameters.highQuality = isNonRealtime();
     
     auto mainInput = getBusBuffer(buffer, true, 0);
-    auto mainInputChannels = mainInput.getNumChannels();
-    auto isMainInputStereo = mainInputChannels > 1;
-    const float* inputDataL = mainInput.getReadPointer(0);
-    const float* inputDataR = mainInput.getReadPointer(isMainInputStereo ? 1 : 0);
-    
     auto mainOutput = getBusBuffer(buffer, false, 0);
-    auto mainOutputChannels = mainOutput.getNumChannels();
-    auto isMainOutputStereo = mainOutputChannels > 1;
-    float* outputDataL = mainOutput.getWritePointer(0);
-    float* outputDataR = mainOutput.getWritePointer(isMainOutputStereo ? 1 : 0);
-    
-    float maxL = 0.0f;
-    float maxR = 0.0f;
-    
-    if (isMainOutputStereo){
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample){
-            params.smoothen();
-            
-            // No crossfade
-            //float delayTime = params.tempoSync ? syncedTime : params.delayTime;
-            //delayInSamples = delayTime / 1000.0f * sampleRate;
-            
-            /*
-            // Crossfade
-            if (xfade == 0.0f) {
-                float delayTime = params.tempoSync ? syncedTime : params.delayTime;
-                targetDelay = delayTime / 1000.0f * sampleRate;
-                
-                if (delayInSamples == 0.0f) { // first time
-                    delayInSamples = targetDelay;
-                }
-                
-                else if (targetDelay != delayInSamples) {  // start crossfade
-                    xfade = xfadeInc;
-                }
-            }
-             */
-            
-            // Ducking
-            float delayTime = params.tempoSync ? syncedTime : params.delayTime;
-            float newTargetDelay = delayTime / 1000.0f * sampleRate;
-            
-            if (newTargetDelay != targetDelay) {
-                targetDelay = newTargetDelay;
-                
-                if (delayInSamples == 0.0f) {
-                    delayInSamples = targetDelay;
-                }
-                else {
-                    wait = waitInc;
-                    fadeTarget = 0.0f;
-                }
-            }
-            
-            lowCutFilter.setCutoffFrequency(params.lowCut);
-            highCutFilter.setCutoffFrequency(params.highCut);
-            
-            float dryL = inputDataL[sample];
-            float dryR = inputDataR[sample];
-            
-            float mono = (dryL + dryR) * 0.5f;
-            
-            delayLineL.write(mono * params.panL + feedbackL);
-            delayLineR.write(mono * params.panR + feedbackR);
-            
-            float wetL = delayLineL.read(delayInSamples);
-            float wetR = delayLineR.read(delayInSamples);
-            
-            /*
-            // If crossfade is turned on
-            if (xfade > 0.0f) { // crossfading?
-                float newL = delayLineL.read(targetDelay);
-                float newR = delayLineR.read(targetDelay);
-                
-                wetL = (1.0f - xfade) * wetL + xfade * newL;
-                wetR = (1.0f - xfade) * wetR + xfade * newR;
-                
-                xfade += xfadeInc;
-                if (xfade >= 1.0f) {
-                    delayInSamples = targetDelay;
-                    xfade = 0.0f;
-                }
-            }
-             */
-            
-            // Ducking
-            fade += (fadeTarget - fade) * coeff;
-            
-            wetL *= fade;
-            wetR *= fade;
-            
-            if (wait > 0.0f) {
-                wait += waitInc;
-                if (wait >= 1.0f) {
-                    delayInSamples = targetDelay;
-                    wait = 0.0f;
-                    fadeTarget = 1.0f;
-                }
-            }
-            
-            feedbackL = wetL * params.feedback;
-            feedbackL = lowCutFilter.processSample(0, feedbackL);
-            feedbackL = highCutFilter.processSample(0, feedbackL);
-            
-            feedbackR = wetR * params.feedback;
-            feedbackR = lowCutFilter.processSample(1, feedbackR);
-            feedbackR = highCutFilter.processSample(1, feedbackR);
-            
-            float mixL = dryL + wetL * params.mix;
-            float mixR = dryR + wetR * params.mix;
-            
-            float outL = mixL * params.gain;
-            float outR = mixR * params.gain;
-            
-            if (params.bypassed) {
-                outL = dryL;
-                outR = dryR;
-            }
-            
-            outputDataL[sample] = outL;
-            outputDataR[sample] = outR;
-            
-            maxL = std::max(maxL, std::abs(outL));
-            maxR = std::max(maxR, std::abs(outR));
-        }
-        
-        levelL.updateIfGreater(maxL);
-        levelR.updateIfGreater(maxR);
-    }
-    else {
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample){
-            params.smoothen();
-            
-            delayInSamples = (params.delayTime / 1000.0f) * sampleRate;
-            
-            float dry = inputDataL[sample];
-            
-            delayLineL.write(params.panL + feedbackL);
-            
-            float wet = delayLineL.read(delayInSamples);
-            
-            feedbackL = wet * params.feedback;
-            
-            float mix = dry + wet * params.mix;
-            
-            outputDataL[sample] = mix * params.gain;
-        }
-    }
-
+    
+    engine.process({ mainInput.getArrayOfReadPointers(), size_t(mainInput.getNumChannels()) },
+                   { mainOutput.getArrayOfWritePointers(), size_t(mainOutput.getNumChannels()) },
+                   buffer.getNumSamples(), parameters);
+    DDDELAYYY_PROFILE_LAP(profiler, engine);
+    
+    // Metering runs over the finished block
+    auto isMainOutputStereo = mainOutput.getNumChannels() > 1;
+    const float* outputDataL = mainOutput.getReadPointer(0);
+    const float* outputDataR = mainOutput.getReadPointer(isMainOutputStereo ? 1 : 0);
+    
+    auto frameL = outputMeter.measure(0, outputDataL, buffer.getNumSamples());
+    auto frameR = isMainOutputStereo ? outputMeter.measure(1, outputDataR, buffer.getNumSamples()) : frameL;
+    levelL.push(frameL);
+    levelR.push(frameR);
+    
+    loudness.process(outputDataL, isMainOutputStereo ? outputDataR : nullptr, buffer.getNumSamples());
     
 #if JUCE_DEBUG
     protectYourEars(buffer);
 #endif
+    
+    DDDELAYYY_PROFILE_LAP(profiler, output);
+    DDDELAYYY_PROFILE_END(profiler, buffer.getNumSamples());
 }
 
 //==============================================================================
@@ -355,15 +294,35 @@ void DddelayyyAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
     //DBG(apvts.copyState().toXmlString());
     
-    copyXmlToBinary(*apvts.copyState().createXml(), destData);
+    //copyXmlToBinary(*apvts.copyState().createXml(), destData);
+    stateFormat.write(destData);
 }
 
 void DddelayyyAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
-    if( xml.get() != nullptr && xml->hasTagName(apvts.state.getType())){
-        apvts.replaceState(juce::ValueTree::fromXml(*xml));
+    // A restored state wins over a program change that hasn't landed yet,
+    // and over one that is still fading out
+    pendingProgram.store(-1);
+    programSwitchCancelled.store(true);
+    
+    if (!stateFormat.read(data, sizeInBytes)) {
+        // Sessions saved before the binary format still hold XML
+        std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
+        if( xml.get() != nullptr && xml->hasTagName(apvts.state.getType())){
+            apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        }
+    }
+    
+    // Show the program the state came from, if it is still untouched
+    loadPresets();
+    for (int i = 0; i < presets.size(); ++i) {
+        if (stateFormat.matches(presets.getSnapshot(i))) {
+            currentProgram.store(i);
+            break;
+        }
     }
+    
+    restoringState.store(true);
 }
 
 //==============================================================================
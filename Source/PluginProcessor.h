@@ -9,16 +9,22 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <mutex>
 #include "Parameters.h"
 #include "Tempo.h"
-#include "DelayLine.h"
+#include "DelayEngine.h"
 #include "Measurement.h"
+#include "OutputMeter.h"
+#include "Loudness.h"
+#include "StateFormat.h"
+#include "PresetBank.h"
+#include "Profiler.h"
 
 
 //==============================================================================
 /**
 */
-class DddelayyyAudioProcessor  : public juce::AudioProcessor
+class DddelayyyAudioProcessor  : public juce::AudioProcessor, private juce::Timer
 {
 public:
     //==============================================================================
@@ -62,31 +68,53 @@ public:
     
     Parameters params;
     
+    // All of the DSP, the processor only feeds it
+    DelayEngine engine;
+    
     Measurement levelL, levelR;
     
+    LoudnessMeter loudness;
+    
+   #if DDDELAYYY_PROFILING
+    Profiler profiler;
+   #endif
+    
     // Bypass button
     juce::AudioProcessorParameter* getBypassParameter() const override;
 
 private:
-    //juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Linear> delayLine;
-    DelayLine delayLineL, delayLineR;
-    float feedbackL = 0.0f;
-    float feedbackR = 0.0f;
-    juce::dsp::StateVariableTPTFilter<float> lowCutFilter;
-    juce::dsp::StateVariableTPTFilter<float> highCutFilter;
+    StateFormat stateFormat;
+    PresetBank presets;
+    
+    // The bank file is read the first time the host asks about programs,
+    // not for every instance a host creates while scanning
+    std::once_flag presetsLoaded;
+    void loadPresets();
+    
+    // Program changes: the engine mutes the wet signal, the preset's snapshot
+    // is stored into the parameters at the start of the block after it went
+    // silent, and the wet signal fades back in while the parameters glide to
+    // their new values. The host and the editor hear about it from the timer.
+    std::atomic<int> currentProgram { 0 };
+    std::atomic<int> pendingProgram { -1 };
+    std::atomic<int> programToNotify { -1 };
+    std::atomic<bool> prepared { false };
+    int switchingProgram = -1;
+    std::atomic<bool> programSwitchCancelled { false };
+    
+    // Set by setStateInformation() until the next program selection or block
+    std::atomic<bool> restoringState { false };
+    
+    void updateProgram() noexcept;
+    
+    // Message thread work that must not wait for an editor: gating and
+    // integrating the loudness, and announcing program changes. Runs only
+    // between prepareToPlay and releaseResources, so instances that are
+    // merely scanned or idle cost nothing.
+    void timerCallback() override;
+    
+    OutputMeter outputMeter;
     Tempo tempo;
-//    float delayInSamples = 0.0f;    // Crossfade
-//    float targetDelay = 0.0f;       // Crossfade
-//    float xfade = 0.0f;             // Crossfade
-//    float xfadeInc = 0.0f;          // Crossfade
-
-    float delayInSamples = 0.0f;
-    float targetDelay = 0.0f;
-    float fade = 0.0f;
-    float fadeTarget = 0.0f;
-    float coeff = 0.0f;
-    float wait = 0.0f;
-    float waitInc = 0.0f;
     
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DddelayyyAudioProcessor)
@@ -0,0 +1,156 @@
+/*
+  ==============================================================================
+
+    PresetBank.cpp
+    Created: 21 Oct 2026 9:12:48am
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#include "PresetBank.h"
+#include "Parameters.h"
+
+PresetBank::PresetBank(const StateFormat& format_) : format(format_)
+{
+    addFactoryPresets();
+}
+
+juce::File PresetBank::getDefaultFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("Gardi Innovation")
+        .getChildFile("dddelayyy")
+        .getChildFile("Presets.ddbank");
+}
+
+float* PresetBank::addPreset(const juce::String& name)
+{
+    int numParameters = format.getNumParameters();
+    
+    names.add(name);
+    snapshots.resize(snapshots.size() + size_t(numParameters));
+    
+    float* snapshot = snapshots.data() + snapshots.size() - size_t(numParameters);
+    format.getDefaults(snapshot);
+    
+    // Switching programs should never bypass the plug-in or change its CPU load
+    for (auto& id : { bypassParamID, oversamplingParamID }) {
+        int index = format.indexOf(id.getParamID());
+        if (index >= 0) {
+            snapshot[index] = std::numeric_limits<float>::quiet_NaN();
+        }
+    }
+    return snapshot;
+}
+
+void PresetBank::set(float* snapshot, const juce::ParameterID& id, float value) const noexcept
+{
+    int index = format.indexOf(id.getParamID());
+    jassert(index >= 0);
+    if (index >= 0) {
+        snapshot[index] = format.getParameter(index).convertTo0to1(value);
+    }
+}
+
+void PresetBank::addFactoryPresets()
+{
+    addPreset("Init");
+    
+    auto* slapback = addPreset("Slapback");
+    set(slapback, delayTimeParamID, 110.0f);
+    set(slapback, mixParamID, 35.0f);
+    set(slapback, feedbackParamID, 10.0f);
+    set(slapback, highCutParamID, 6000.0f);
+    
+    auto* pingPong = addPreset("Ping Pong");
+    set(pingPong, tempoSyncParamID, 1.0f);
+    set(pingPong, delayNoteParamID, 8.0f); // 1/8 dot
+    set(pingPong, mixParamID, 40.0f);
+    set(pingPong, feedbackParamID, 55.0f);
+    set(pingPong, stereoParamID, 100.0f);
+    
+    auto* tape = addPreset("Tape Echo");
+    set(tape, delayTimeParamID, 350.0f);
+    set(tape, mixParamID, 45.0f);
+    set(tape, feedbackParamID, 35.0f);
+    set(tape, lowCutParamID, 150.0f);
+    set(tape, highCutParamID, 4000.0f);
+    set(tape, driveParamID, 40.0f);
+    
+    auto* dub = addPreset("Dub Space");
+    set(dub, tempoSyncParamID, 1.0f);
+    set(dub, delayNoteParamID, 9.0f); // 1/4
+    set(dub, mixParamID, 50.0f);
+    set(dub, feedbackParamID, 50.0f);
+    set(dub, lowCutParamID, 300.0f);
+    set(dub, highCutParamID, 2500.0f);
+    set(dub, driveParamID, 30.0f);
+    set(dub, diffuseParamID, 40.0f);
+    
+    auto* wash = addPreset("Ambient Wash");
+    set(wash, delayTimeParamID, 800.0f);
+    set(wash, mixParamID, 50.0f);
+    set(wash, feedbackParamID, 70.0f);
+    set(wash, stereoParamID, 60.0f);
+    set(wash, highCutParamID, 8000.0f);
+    set(wash, diffuseParamID, 90.0f);
+}
+
+bool PresetBank::load(const juce::File& file)
+{
+    if (!file.existsAsFile()) { return false; }
+    
+    juce::MemoryMappedFile mapped(file, juce::MemoryMappedFile::readOnly);
+    if (mapped.getData() == nullptr) { return false; }
+    
+    // Parse over an empty bank, and put the old one back if the file is broken
+    auto oldNames = std::move(names);
+    auto oldSnapshots = std::move(snapshots);
+    names.clear();
+    snapshots.clear();
+    
+    if (!parse(static_cast<const char*>(mapped.getData()), mapped.getSize())) {
+        names = std::move(oldNames);
+        snapshots = std::move(oldSnapshots);
+        return false;
+    }
+    return true;
+}
+
+bool PresetBank::parse(const char* data, size_t size)
+{
+    if (size < 8) { return false; }
+    
+    juce::MemoryInputStream stream(data, size, false);
+    if (std::uint32_t(stream.readInt()) != magic) { return false; }
+    
+    auto dataVersion = std::uint16_t(stream.readShort());
+    if (dataVersion == 0 || dataVersion > version) { return false; }
+    
+    int numPresets = int(std::uint16_t(stream.readShort()));
+    if (numPresets == 0) { return false; }
+    
+    std::array<float, StateFormat::maxParameters> state;
+    
+    for (int i = 0; i < numPresets; ++i) {
+        auto nameLength = juce::int64(std::uint16_t(stream.readShort()));
+        if (stream.getNumBytesRemaining() < nameLength) { return false; }
+        auto name = juce::String::fromUTF8(data + stream.getPosition(), int(nameLength));
+        stream.skipNextBytes(nameLength);
+        
+        auto stateSize = juce::int64(std::uint32_t(stream.readInt()));
+        if (stream.getNumBytesRemaining() < stateSize) { return false; }
+        if (!format.readSnapshot(data + stream.getPosition(), int(stateSize), state.data())) { return false; }
+        stream.skipNextBytes(stateSize);
+        
+        // Keep the NaNs addPreset puts in for the parameters presets don't touch
+        float* snapshot = addPreset(name);
+        for (int p = 0; p < format.getNumParameters(); ++p) {
+            if (!std::isnan(snapshot[p])) {
+                snapshot[p] = state[size_t(p)];
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    PresetBank.h
+    Created: 21 Oct 2026 9:12:48am
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "StateFormat.h"
+
+//==============================================================================
+/*
+    The programs, each kept as a ready-made parameter snapshot so switching
+    is just a copy of normalised values into the parameters.
+
+    The factory presets are built in. A bank file in the user's application
+    data folder replaces them. The file is memory-mapped and parsed once:
+
+        uint32  magic 'DDBK'
+        uint16  version
+        uint16  number of presets
+        uint16  name length      }
+        bytes   UTF-8 name       } repeated
+        uint32  state size       }
+        bytes   binary state     }
+
+    The state of each preset is exactly what getStateInformation writes.
+    Presets never change bypass or the oversampling setting.
+*/
+class PresetBank
+{
+public:
+    explicit PresetBank(const StateFormat& format);
+    
+    // Keeps the factory presets if the file is missing or not a valid bank
+    bool load(const juce::File& file);
+    
+    static juce::File getDefaultFile();
+    
+    int size() const noexcept { return names.size(); }
+    juce::String getName(int index) const { return names[index]; }
+    
+    const float* getSnapshot(int index) const noexcept
+    {
+        return snapshots.data() + size_t(index * format.getNumParameters());
+    }
+    
+    static constexpr std::uint32_t magic = 0x4B424444; // "DDBK"
+    static constexpr std::uint16_t version = 1;
+    
+private:
+    void addFactoryPresets();
+    bool parse(const char* data, size_t size);
+    
+    // Appends a preset with default values and returns its snapshot
+    float* addPreset(const juce::String& name);
+    
+    void set(float* snapshot, const juce::ParameterID& id, float value) const noexcept;
+    
+    const StateFormat& format;
+    
+    juce::StringArray names;
+    
+    // All presets back to back, getNumParameters() values each
+    std::vector<float> snapshots;
+};
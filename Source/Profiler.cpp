@@ -0,0 +1,213 @@
+/*
+  ==============================================================================
+
+    Profiler.cpp
+    Created: 29 Oct 2026 10:18:44am
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#include "Profiler.h"
+
+#if DDDELAYYY_PROFILING
+
+static std::int64_t steadyNanoseconds() noexcept
+{
+    auto time = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+}
+
+const char* Profiler::getStageName(int stage) noexcept
+{
+    switch (stage) {
+        case parameters: return "parameters";
+        case tempo: return "tempo";
+        case engine: return "engine";
+        case output: return "output";
+        default: return "processBlock";
+    }
+}
+
+int Profiler::binForTicks(std::uint64_t ticks) noexcept
+{
+    if (ticks < 4) { return int(ticks); }
+    
+    // The octave picks the group of four, the next two bits the quarter
+    int octave = int(std::bit_width(ticks)) - 1;
+    int quarter = int((ticks >> (octave - 2)) & 3);
+    return std::min(4 * (octave - 1) + quarter, numBins - 1);
+}
+
+double Profiler::ticksForBin(int bin) noexcept
+{
+    if (bin < 4) { return double(bin); }
+    
+    int octave = bin / 4 + 1;
+    int quarter = bin % 4;
+    double width = double(std::uint64_t(1) << (octave - 2));
+    return (double(4 + quarter) + 0.5) * width;
+}
+
+void Profiler::prepare(double newSampleRate) noexcept
+{
+    referenceTicks.store(now());
+    referenceNanoseconds.store(steadyNanoseconds());
+    sampleRate.store(newSampleRate);
+}
+
+void Profiler::endBlock(int numSamples) noexcept
+{
+    Frame frame;
+    frame.start = blockStart;
+    frame.numSamples = std::uint32_t(numSamples);
+    
+    for (int stage = 0; stage <= numStages; ++stage) {
+        auto ticks = stage == block ? lastLap - blockStart : accumulated[size_t(stage)];
+        
+        // Only this thread writes, so a load and a store beat a locked add
+        auto& histogram = histograms[size_t(stage)];
+        auto& bin = histogram.bins[size_t(binForTicks(ticks))];
+        bin.store(bin.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        histogram.sum.store(histogram.sum.load(std::memory_order_relaxed) + ticks, std::memory_order_relaxed);
+        histogram.count.store(histogram.count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        
+        frame.ticks[size_t(stage)] = std::uint32_t(std::min<std::uint64_t>(ticks, 0xffffffff));
+    }
+    
+    totalSamples.store(totalSamples.load(std::memory_order_relaxed) + std::uint64_t(numSamples), std::memory_order_relaxed);
+    frames.push(frame);
+}
+
+Profiler::Snapshot Profiler::snapshot(int stage) const noexcept
+{
+    auto& histogram = histograms[size_t(stage)];
+    
+    Snapshot result;
+    result.count = histogram.count.load(std::memory_order_acquire);
+    result.sum = histogram.sum.load(std::memory_order_relaxed);
+    result.samples = totalSamples.load(std::memory_order_relaxed);
+    for (int i = 0; i < numBins; ++i) {
+        result.bins[size_t(i)] = histogram.bins[size_t(i)].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+Profiler::Statistics Profiler::summarize(const Snapshot& current, const Snapshot& previous) const noexcept
+{
+    Statistics result;
+    result.blocks = current.count - previous.count;
+    if (result.blocks == 0) { return result; }
+    
+    double ticksPerSecond = getTicksPerSecond();
+    double microsecondsPerTick = 1e6 / ticksPerSecond;
+    double sum = double(current.sum - previous.sum);
+    result.mean = sum / double(result.blocks) * microsecondsPerTick;
+    
+    // The snapshots are taken while the audio thread runs, so the bins may
+    // hold a block or two more or less than the count says
+    double total = 0.0;
+    for (int i = 0; i < numBins; ++i) {
+        total += double(current.bins[size_t(i)] - previous.bins[size_t(i)]);
+    }
+    
+    double seen = 0.0;
+    for (int i = 0; i < numBins; ++i) {
+        auto count = double(current.bins[size_t(i)] - previous.bins[size_t(i)]);
+        if (count == 0.0) { continue; }
+        
+        seen += count;
+        double time = ticksForBin(i) * microsecondsPerTick;
+        if (result.p50 == 0.0 && seen >= 0.5 * total) { result.p50 = time; }
+        if (result.p99 == 0.0 && seen >= 0.99 * total) { result.p99 = time; }
+        result.max = time;
+    }
+    
+    double audioSeconds = double(current.samples - previous.samples) / sampleRate.load();
+    if (audioSeconds > 0.0) {
+        result.load = sum / ticksPerSecond / audioSeconds;
+    }
+    return result;
+}
+
+double Profiler::getTicksPerSecond() const noexcept
+{
+   #if JUCE_INTEL
+    // Measured against the steady clock over everything since prepare()
+    auto ticks = now() - referenceTicks.load();
+    auto nanoseconds = steadyNanoseconds() - referenceNanoseconds.load();
+    if (nanoseconds > 0 && ticks > 0) {
+        return double(ticks) * 1e9 / double(nanoseconds);
+    }
+   #endif
+    return 1e9;
+}
+
+double Profiler::ticksToNanoseconds(std::uint64_t ticks) const noexcept
+{
+    auto sinceReference = double(std::int64_t(ticks - referenceTicks.load()));
+    return double(referenceNanoseconds.load()) + sinceReference * 1e9 / getTicksPerSecond();
+}
+
+//==============================================================================
+void ProfileTrace::beginRun(const juce::String& name)
+{
+    runNames.add(name);
+}
+
+void ProfileTrace::collect(Profiler& profiler)
+{
+    jassert(!runNames.isEmpty());
+    
+    double nanosecondsPerTick = 1e9 / profiler.getTicksPerSecond();
+    
+    Profiler::Frame frame;
+    while (profiler.popFrame(frame)) {
+        Event event;
+        event.run = runNames.size() - 1;
+        event.start = profiler.ticksToNanoseconds(frame.start) / 1000.0;
+        event.numSamples = frame.numSamples;
+        for (size_t i = 0; i < frame.ticks.size(); ++i) {
+            event.durations[i] = double(frame.ticks[i]) * nanosecondsPerTick / 1000.0;
+        }
+        events.push_back(event);
+    }
+}
+
+bool ProfileTrace::write(const juce::File& file) const
+{
+    double origin = events.empty() ? 0.0 : events.front().start;
+    
+    juce::MemoryOutputStream out;
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        
+    for (int run = 0; run < runNames.size(); ++run) {
+        out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << (run + 1)
+            << ",\"args\":{\"name\":" << juce::JSON::toString(runNames[run]) << "}},\n";
+    }
+        
+    auto writeSlice = [&out](const char* name, int pid, double start, double duration, std::uint32_t numSamples)
+    {
+        out << "{\"name\":\"" << name << "\",\"cat\":\"dsp\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":1"
+            << ",\"ts\":" << juce::String(start, 3) << ",\"dur\":" << juce::String(duration, 3)
+            << ",\"args\":{\"samples\":" << int(numSamples) << "}}";
+    };
+        
+    for (size_t i = 0; i < events.size(); ++i) {
+        auto& event = events[i];
+        double start = event.start - origin;
+        writeSlice(Profiler::getStageName(Profiler::block), event.run + 1, start, event.durations[size_t(Profiler::block)], event.numSamples);
+            
+        for (int stage = 0; stage < Profiler::numStages; ++stage) {
+            out << ",\n";
+            writeSlice(Profiler::getStageName(stage), event.run + 1, start, event.durations[size_t(stage)], event.numSamples);
+            start += event.durations[size_t(stage)];
+        }
+        out << (i + 1 < events.size() ? ",\n" : "\n");
+    }
+        
+    out << "]}\n";
+    return file.replaceWithData(out.getData(), out.getDataSize());
+}
+
+#endif
@@ -0,0 +1,202 @@
+/*
+  ==============================================================================
+
+    Profiler.h
+    Created: 29 Oct 2026 10:18:44am
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Build with DDDELAYYY_PROFILING=1 (the Profile configurations do) to time
+// the stages of processBlock. Without it nothing below is compiled and the
+// macros expand to nothing.
+#ifndef DDDELAYYY_PROFILING
+ #define DDDELAYYY_PROFILING 0
+#endif
+
+#if DDDELAYYY_PROFILING
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include "Measurement.h"
+
+#if JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+//==============================================================================
+/*
+    Per-stage timing of the audio callback. The audio thread marks the end
+    of each stage with lap(), which adds the time since the previous lap to
+    that stage. Laps are taken once per block, between the stages of
+    processBlock; timing inside the per-sample loop would cost as much as the
+    work it measures. At the end of the block every stage's total goes into
+    a histogram and the block is queued for trace output.
+
+    The histograms have a single writer and are read with relaxed loads, so
+    a reader sees a consistent-enough picture without ever blocking the
+    audio thread. Readers take snapshots and compare two of them to get the
+    statistics for the interval in between.
+*/
+class Profiler
+{
+public:
+    enum Stage { parameters, tempo, engine, output, numStages };
+    
+    // The whole block is recorded after the stages, under this index
+    static constexpr int block = numStages;
+    
+    Profiler() = default;
+    
+    static const char* getStageName(int stage) noexcept;
+    
+    // Time stamp in ticks: the time stamp counter on Intel, nanoseconds elsewhere
+    static std::uint64_t now() noexcept
+    {
+       #if JUCE_INTEL
+        return __rdtsc();
+       #else
+        auto time = std::chrono::steady_clock::now().time_since_epoch();
+        return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count());
+       #endif
+    }
+    
+    // Quarter-octave bins, from one tick up to about 2^33
+    static constexpr int numBins = 128;
+    
+    struct Histogram
+    {
+        std::array<std::atomic<std::uint32_t>, numBins> bins {};
+        std::atomic<std::uint64_t> count { 0 };
+        std::atomic<std::uint64_t> sum { 0 };
+    };
+    
+    struct Snapshot
+    {
+        std::array<std::uint32_t, numBins> bins {};
+        std::uint64_t count = 0;
+        std::uint64_t sum = 0;
+        std::uint64_t samples = 0;
+    };
+    
+    // Times in microseconds, load as a share of the real time the blocks cover
+    struct Statistics
+    {
+        std::uint64_t blocks = 0;
+        double mean = 0.0;
+        double p50 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+        double load = 0.0;
+    };
+    
+    // One block's stage totals in ticks, the last entry is the whole block
+    struct Frame
+    {
+        std::uint64_t start = 0;
+        std::uint32_t numSamples = 0;
+        std::array<std::uint32_t, numStages + 1> ticks {};
+    };
+    
+    static int binForTicks(std::uint64_t ticks) noexcept;
+    static double ticksForBin(int bin) noexcept;
+    
+    // Restarts the clock calibration. Call from prepareToPlay.
+    void prepare(double sampleRate) noexcept;
+    
+    // Audio thread
+    void beginBlock() noexcept
+    {
+        blockStart = now();
+        lastLap = blockStart;
+        accumulated.fill(0);
+    }
+    
+    void lap(Stage stage) noexcept
+    {
+        auto time = now();
+        accumulated[size_t(stage)] += time - lastLap;
+        lastLap = time;
+    }
+    
+    void endBlock(int numSamples) noexcept;
+    
+    // Any thread
+    Snapshot snapshot(int stage) const noexcept;
+    Statistics summarize(const Snapshot& current, const Snapshot& previous) const noexcept;
+    double getTicksPerSecond() const noexcept;
+    
+    // Converts a time stamp from now() to nanoseconds on the steady clock
+    double ticksToNanoseconds(std::uint64_t ticks) const noexcept;
+    
+    // Trace consumer. The queue drops blocks when nobody reads it.
+    bool popFrame(Frame& frame) noexcept { return frames.pop(frame); }
+    
+private:
+    std::array<Histogram, numStages + 1> histograms;
+    std::atomic<std::uint64_t> totalSamples { 0 };
+    FrameFifo<Frame, 1024> frames;
+    
+    std::uint64_t blockStart = 0;
+    std::uint64_t lastLap = 0;
+    std::array<std::uint64_t, numStages> accumulated {};
+    
+    std::atomic<std::uint64_t> referenceTicks { 0 };
+    std::atomic<std::int64_t> referenceNanoseconds { 0 };
+    std::atomic<double> sampleRate { 44100.0 };
+    
+    JUCE_DECLARE_NON_COPYABLE(Profiler)
+};
+
+//==============================================================================
+// Collects blocks from headless runs and writes them as a Chrome trace,
+// which chrome://tracing and ui.perfetto.dev both open. Each run shows up
+// as its own process; within a block the stages follow each other.
+class ProfileTrace
+{
+public:
+    void beginRun(const juce::String& name);
+    
+    // Drains the profiler's queue; call it often enough that it never fills
+    void collect(Profiler& profiler);
+    
+    bool write(const juce::File& file) const;
+    
+private:
+    struct Event
+    {
+        int run;
+        double start;
+        std::uint32_t numSamples;
+        std::array<double, Profiler::numStages + 1> durations;
+    };
+    
+    juce::StringArray runNames;
+    std::vector<Event> events;
+};
+
+#define DDDELAYYY_PROFILE_BEGIN(profiler) (profiler).beginBlock()
+#define DDDELAYYY_PROFILE_LAP(profiler, stage) (profiler).lap(Profiler::stage)
+#define DDDELAYYY_PROFILE_END(profiler, numSamples) (profiler).endBlock(numSamples)
+
+#else
+
+class ProfileTrace;
+
+#define DDDELAYYY_PROFILE_BEGIN(profiler) ((void) 0)
+#define DDDELAYYY_PROFILE_LAP(profiler, stage) ((void) 0)
+#define DDDELAYYY_PROFILE_END(profiler, numSamples) ((void) 0)
+
+#endif
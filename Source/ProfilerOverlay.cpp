@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    ProfilerOverlay.cpp
+    Created: 29 Oct 2026 2:36:10pm
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "ProfilerOverlay.h"
+#include "LookAndFeel.h"
+
+#if DDDELAYYY_PROFILING
+
+//==============================================================================
+ProfilerOverlay::ProfilerOverlay(Profiler& profiler_) : profiler(profiler_)
+{
+    for (int stage = 0; stage <= Profiler::numStages; ++stage) {
+        previous[size_t(stage)] = profiler.snapshot(stage);
+    }
+    startTimerHz(refreshRate);
+}
+
+ProfilerOverlay::~ProfilerOverlay()
+{
+}
+
+juce::Rectangle<int> ProfilerOverlay::getLabelBounds() const
+{
+    // In the header, left of the bypass button
+    return { getWidth() - 180, 10, 140, 20 };
+}
+
+juce::Rectangle<int> ProfilerOverlay::getPanelBounds() const
+{
+    return getLocalBounds().withTrimmedTop(40).withSizeKeepingCentre(360, 160).withY(50);
+}
+
+bool ProfilerOverlay::hitTest(int x, int y)
+{
+    return getLabelBounds().contains(x, y) || (expanded && getPanelBounds().contains(x, y));
+}
+
+void ProfilerOverlay::mouseDown(const juce::MouseEvent&)
+{
+    expanded = !expanded;
+    repaint(getPanelBounds());
+}
+
+void ProfilerOverlay::paint (juce::Graphics& g)
+{
+    auto& total = statistics[size_t(Profiler::block)];
+    
+    g.setFont(Fonts::getFont(12.0f));
+    g.setColour(Colors::Loudness::text);
+    g.drawText("DSP " + juce::String(total.load * 100.0, 1) + " %   p99 " + juce::String(total.p99, 1) + " us",
+               getLabelBounds(), juce::Justification::centredRight);
+    
+    if (!expanded) { return; }
+    
+    auto panel = getPanelBounds();
+    g.setColour(Colors::header.withAlpha(0.92f));
+    g.fillRoundedRectangle(panel.toFloat(), 4.0f);
+    
+    auto area = panel.reduced(12, 8);
+    int rowHeight = area.getHeight() / (Profiler::numStages + 2);
+    
+    auto drawRow = [&](juce::StringArray cells)
+    {
+        auto row = area.removeFromTop(rowHeight);
+        g.drawText(cells[0], row.removeFromLeft(100), juce::Justification::centredLeft);
+        for (int i = 1; i < cells.size(); ++i) {
+            g.drawText(cells[i], row.removeFromLeft(row.getWidth() / (cells.size() - i)), juce::Justification::centredRight);
+        }
+    };
+    
+    g.setColour(Colors::Group::label);
+    drawRow({ "us per block", "mean", "p99", "max", "load %" });
+    
+    g.setColour(Colors::Knob::value);
+    for (int stage = 0; stage <= Profiler::numStages; ++stage) {
+        auto& s = statistics[size_t(stage)];
+        drawRow({ Profiler::getStageName(stage),
+                  juce::String(s.mean, 1),
+                  juce::String(s.p99, 1),
+                  juce::String(s.max, 1),
+                  juce::String(s.load * 100.0, 2) });
+    }
+}
+
+void ProfilerOverlay::timerCallback()
+{
+    if (!isShowing()) { return; }
+    
+    for (int stage = 0; stage <= Profiler::numStages; ++stage) {
+        auto current = profiler.snapshot(stage);
+        statistics[size_t(stage)] = profiler.summarize(current, previous[size_t(stage)]);
+        previous[size_t(stage)] = current;
+    }
+    
+    // Only the parts that change, the knobs underneath stay as they are
+    repaint(getLabelBounds());
+    if (expanded) {
+        repaint(getPanelBounds());
+    }
+}
+
+#endif
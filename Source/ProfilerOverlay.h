@@ -0,0 +1,53 @@
+/*
+  ==============================================================================
+
+    ProfilerOverlay.h
+    Created: 29 Oct 2026 2:36:10pm
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Profiler.h"
+
+#if DDDELAYYY_PROFILING
+
+//==============================================================================
+/*
+    Only in profiling builds. Shows the DSP load in the header; click it to
+    open a table of the time spent in each stage over the last refresh
+    interval, click again to close it. Covers the whole editor but only
+    takes mouse clicks where it draws.
+*/
+class ProfilerOverlay  : public juce::Component, private juce::Timer
+{
+public:
+    ProfilerOverlay(Profiler& profiler);
+    ~ProfilerOverlay() override;
+    
+    void paint (juce::Graphics&) override;
+    bool hitTest(int x, int y) override;
+    void mouseDown(const juce::MouseEvent&) override;
+    
+private:
+    void timerCallback() override;
+    
+    juce::Rectangle<int> getLabelBounds() const;
+    juce::Rectangle<int> getPanelBounds() const;
+    
+    Profiler& profiler;
+    
+    static constexpr int refreshRate = 4;
+    
+    std::array<Profiler::Snapshot, Profiler::numStages + 1> previous;
+    std::array<Profiler::Statistics, Profiler::numStages + 1> statistics;
+    
+    bool expanded = false;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProfilerOverlay)
+};
+
+#endif
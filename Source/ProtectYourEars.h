@@ -34,3 +34,125 @@ inline void protectYourEars(juce::AudioBuffer<float>& buffer)
         }
     }
 }
+
+// Release-safe output guard. Scans a channel for nan/inf and its peak level.
+// x * 0 is 0 for any finite x but nan for nan or inf, so summing these values
+// poisons the accumulator and a single compare at the end finds them all.
+inline bool scanOutput(const float* data, int numSamples, float& peak) noexcept
+{
+    float poison = 0.0f;
+    float maxAbs = 0.0f;
+    int sample = 0;
+    
+   #if JUCE_USE_SIMD
+    using Vec = juce::dsp::SIMDRegister<float>;
+    
+    // Scalar head until the data is aligned for SIMD loads
+    for (; sample < numSamples && !Vec::isSIMDAligned(data + sample); ++sample) {
+        poison += data[sample] * 0.0f;
+        maxAbs = std::max(maxAbs, std::abs(data[sample]));
+    }
+    
+    auto poisonVec = Vec::expand(0.0f);
+    auto maxVec = Vec::expand(0.0f);
+    const int vecSize = int(Vec::size());
+    for (; sample + vecSize <= numSamples; sample += vecSize) {
+        auto x = Vec::fromRawArray(data + sample);
+        poisonVec += x * 0.0f;
+        maxVec = Vec::max(maxVec, Vec::abs(x));
+    }
+    
+    poison += poisonVec.sum();
+    for (size_t i = 0; i < Vec::size(); ++i) {
+        maxAbs = std::max(maxAbs, maxVec.get(i));
+    }
+   #endif
+    
+    for (; sample < numSamples; ++sample) {
+        poison += data[sample] * 0.0f;
+        maxAbs = std::max(maxAbs, std::abs(data[sample]));
+    }
+    
+    peak = std::max(peak, maxAbs);
+    return poison == 0.0f;
+}
+
+// Soft limiter that leaves everything below the knee untouched and bends
+// louder samples smoothly towards the ceiling.
+inline void softLimitOutput(float* data, int numSamples, float knee, float ceiling) noexcept
+{
+    const float range = ceiling - knee;
+    for (int sample = 0; sample < numSamples; ++sample) {
+        float x = data[sample];
+        float level = std::abs(x);
+        if (level > knee) {
+            level = knee + range * std::tanh((level - knee) / range);
+            data[sample] = std::copysign(level, x);
+        }
+    }
+}
+
+// The plug-in's last output stage, in release builds too. Anything louder
+// than 0 dB is soft limited towards +6 dB on purpose, so a hot mix or a
+// loop that runs away can't leave the plug-in far above full scale. Blocks
+// that stay below the knee only pay for the scan.
+//
+// process() returns false when the caller must reset its feedback state:
+// on nan or inf, after silencing the buffer, and when the output has been
+// pinned above the ceiling for overloadTime, which only a feedback loop
+// that runs away without blowing up will do.
+class OutputGuard
+{
+public:
+    OutputGuard() = default;
+    
+    void prepare(double sampleRate) noexcept
+    {
+        maxOverloadSamples = int(overloadTime * sampleRate);
+        reset();
+    }
+    
+    void reset() noexcept
+    {
+        overloadSamples = 0;
+    }
+    
+    bool process(juce::AudioBuffer<float>& buffer) noexcept
+    {
+        float peak = 0.0f;
+        bool finite = true;
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+            finite &= scanOutput(buffer.getReadPointer(channel), buffer.getNumSamples(), peak);
+        }
+        
+        if (!finite) {
+            buffer.clear();
+            reset();
+            return false;
+        }
+        
+        if (peak > knee) {
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+                softLimitOutput(buffer.getWritePointer(channel), buffer.getNumSamples(), knee, ceiling);
+            }
+        }
+        
+        // Counted in whole blocks, one block under the ceiling starts over
+        overloadSamples = peak > ceiling ? overloadSamples + buffer.getNumSamples() : 0;
+        if (overloadSamples >= maxOverloadSamples) {
+            reset();
+            return false;
+        }
+        return true;
+    }
+    
+private:
+    static constexpr float knee = 1.0f;        // 0 dB
+    static constexpr float ceiling = 2.0f;     // +6 dB
+    static constexpr double overloadTime = 0.5;
+    
+    int maxOverloadSamples = 22050;
+    int overloadSamples = 0;
+    
+    JUCE_DECLARE_NON_COPYABLE (OutputGuard)
+};
@@ -0,0 +1,156 @@
+/*
+  ==============================================================================
+
+    StateFormat.cpp
+    Created: 20 Oct 2026 2:41:07pm
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#include "StateFormat.h"
+
+StateFormat::StateFormat(juce::AudioProcessor& processor)
+{
+    for (auto* p : processor.getParameters()) {
+        if (auto* parameter = dynamic_cast<juce::RangedAudioParameter*>(p)) {
+            entries.push_back({ hash(parameter->getParameterID()), parameter });
+        }
+    }
+    
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.hash < b.hash; });
+    
+    jassert(entries.size() <= size_t(maxParameters));
+    jassert(std::adjacent_find(entries.begin(), entries.end(),
+                               [](const Entry& a, const Entry& b) { return a.hash == b.hash; }) == entries.end());
+}
+
+std::uint32_t StateFormat::hash(const juce::String& parameterID) noexcept
+{
+    std::uint32_t h = 2166136261u;
+    for (auto* c = parameterID.toRawUTF8(); *c != 0; ++c) {
+        h = (h ^ std::uint8_t(*c)) * 16777619u;
+    }
+    return h;
+}
+
+void StateFormat::write(juce::MemoryBlock& destData) const
+{
+    destData.setSize(0);
+    destData.ensureSize(size_t(headerSize + pairSize * int(entries.size())));
+    
+    juce::MemoryOutputStream stream(destData, false);
+    stream.writeInt(int(magic));
+    stream.writeShort(short(version));
+    stream.writeShort(short(entries.size()));
+    
+    for (auto& entry : entries) {
+        stream.writeInt(int(entry.hash));
+        stream.writeFloat(entry.parameter->convertFrom0to1(entry.parameter->getValue()));
+    }
+}
+
+StateFormat::Iterator StateFormat::find(std::uint32_t h) const noexcept
+{
+    auto it = std::lower_bound(entries.begin(), entries.end(), h,
+                               [](const Entry& entry, std::uint32_t value) { return entry.hash < value; });
+    return (it != entries.end() && it->hash == h) ? it : entries.end();
+}
+
+int StateFormat::indexOf(const juce::String& parameterID) const noexcept
+{
+    auto it = find(hash(parameterID));
+    return it == entries.end() ? -1 : int(it - entries.begin());
+}
+
+void StateFormat::getDefaults(float* snapshot) const noexcept
+{
+    for (size_t i = 0; i < entries.size(); ++i) {
+        snapshot[i] = entries[i].parameter->getDefaultValue();
+    }
+}
+
+bool StateFormat::readSnapshot(const void* data, int sizeInBytes, float* snapshot) const
+{
+    if (data == nullptr || sizeInBytes < headerSize) { return false; }
+    
+    juce::MemoryInputStream stream(data, size_t(sizeInBytes), false);
+    if (std::uint32_t(stream.readInt()) != magic) { return false; }
+    
+    // A newer version may change the layout, so don't guess at it
+    auto dataVersion = std::uint16_t(stream.readShort());
+    if (dataVersion == 0 || dataVersion > version) { return false; }
+    
+    int numPairs = int(std::uint16_t(stream.readShort()));
+    if (sizeInBytes < headerSize + numPairs * pairSize) { return false; }
+    
+    // Parameters added since the data was saved start from their defaults,
+    // as they would in a fresh instance
+    getDefaults(snapshot);
+    
+    for (int i = 0; i < numPairs; ++i) {
+        auto id = std::uint32_t(stream.readInt());
+        float value = stream.readFloat();
+        
+        // Parameters that were removed since the data was saved are skipped
+        auto it = find(id);
+        if (it == entries.end() || !std::isfinite(value)) { continue; }
+        
+        snapshot[it - entries.begin()] = it->parameter->convertTo0to1(value);
+    }
+    
+    return true;
+}
+
+void StateFormat::apply(const float* snapshot) const noexcept
+{
+    for (size_t i = 0; i < entries.size(); ++i) {
+        auto* parameter = entries[i].parameter;
+        float value = snapshot[i];
+        if (!std::isnan(value) && parameter->getValue() != value) {
+            parameter->setValueNotifyingHost(value);
+        }
+    }
+}
+
+void StateFormat::store(const float* snapshot) const noexcept
+{
+    for (size_t i = 0; i < entries.size(); ++i) {
+        auto* parameter = entries[i].parameter;
+        float value = snapshot[i];
+        if (!std::isnan(value) && parameter->getValue() != value) {
+            parameter->setValue(value);
+        }
+    }
+}
+
+void StateFormat::notify(const float* snapshot) const noexcept
+{
+    for (size_t i = 0; i < entries.size(); ++i) {
+        auto* parameter = entries[i].parameter;
+        if (!std::isnan(snapshot[i])) {
+            parameter->sendValueChangedMessageToListeners(parameter->getValue());
+        }
+    }
+}
+
+bool StateFormat::matches(const float* snapshot) const noexcept
+{
+    for (size_t i = 0; i < entries.size(); ++i) {
+        // The plain values in the state round to slightly different normalised ones
+        float value = snapshot[i];
+        if (!std::isnan(value) && std::abs(entries[i].parameter->getValue() - value) > 1e-5f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool StateFormat::read(const void* data, int sizeInBytes) const
+{
+    std::array<float, maxParameters> snapshot;
+    if (!readSnapshot(data, sizeInBytes, snapshot.data())) { return false; }
+    
+    apply(snapshot.data());
+    return true;
+}
@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    StateFormat.h
+    Created: 20 Oct 2026 2:41:07pm
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+
+//==============================================================================
+/*
+    Compact binary plug-in state: a fixed header followed by one
+    (parameter ID hash, value) pair per parameter, all little-endian.
+
+        uint32  magic 'DDST'
+        uint16  version
+        uint16  number of pairs
+        uint32  FNV-1a hash of the parameter ID  } repeated
+        float   plain (denormalised) value       }
+
+    Values are stored in plain units like the XML state, so a change of a
+    parameter's range does not shift old sessions. Restoring writes straight
+    into the parameters; the APVTS value tree catches up on its own.
+
+    apply() goes through setValueNotifyingHost(), which takes the
+    processor's listener lock and calls into the host, so it belongs on the
+    message thread. The audio thread uses store() instead and leaves the
+    notifications to notify() on the message thread.
+*/
+class StateFormat
+{
+public:
+    explicit StateFormat(juce::AudioProcessor& processor);
+    
+    void write(juce::MemoryBlock& destData) const;
+    
+    // Returns false and leaves the parameters alone if the data is not in
+    // this format, so the caller can fall back to the XML state
+    bool read(const void* data, int sizeInBytes) const;
+    
+    // A snapshot holds one normalised value per parameter, in the order given
+    // by indexOf(). NaN entries are left alone when the snapshot is applied.
+    int getNumParameters() const noexcept { return int(entries.size()); }
+    int indexOf(const juce::String& parameterID) const noexcept;
+    void getDefaults(float* snapshot) const noexcept;
+    juce::RangedAudioParameter& getParameter(int index) const noexcept { return *entries[size_t(index)].parameter; }
+    
+    // Like read(), but into a snapshot instead of the parameters. Parameters
+    // that are missing from the data get their default value.
+    bool readSnapshot(const void* data, int sizeInBytes, float* snapshot) const;
+    
+    void apply(const float* snapshot) const noexcept;
+    
+    // Only sets the values, which neither locks nor allocates
+    void store(const float* snapshot) const noexcept;
+    
+    // Tells the host and the attachments about values store() has set
+    void notify(const float* snapshot) const noexcept;
+    
+    // True if every value the snapshot sets is what the parameter holds
+    bool matches(const float* snapshot) const noexcept;
+    
+    static constexpr std::uint32_t magic = 0x54534444; // "DDST"
+    static constexpr std::uint16_t version = 1;
+    static constexpr int headerSize = 8;
+    static constexpr int pairSize = 8;
+    
+    // Lets callers keep a snapshot in a fixed-size array
+    static constexpr int maxParameters = 64;
+    
+private:
+    static std::uint32_t hash(const juce::String& parameterID) noexcept;
+    
+    struct Entry
+    {
+        std::uint32_t hash;
+        juce::RangedAudioParameter* parameter;
+    };
+    
+    // Sorted by hash
+    std::vector<Entry> entries;
+    
+    using Iterator = std::vector<Entry>::const_iterator;
+    Iterator find(std::uint32_t h) const noexcept;
+};
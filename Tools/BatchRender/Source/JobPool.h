@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    JobPool.h
+    Created: 27 Oct 2026 10:12:40am
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//==============================================================================
+/*
+    A work-stealing pool for coarse jobs. Jobs are dealt out round-robin to
+    one queue per worker. A worker takes from the front of its own queue and,
+    when that runs dry, steals from the back of someone else's, so a few
+    long files don't leave the other cores idle at the end of a batch.
+
+    Jobs are whole files, so a mutex per queue costs nothing measurable.
+*/
+class JobPool
+{
+public:
+    // job is called as job(workerIndex, jobIndex) on the worker's thread
+    using Job = std::function<void(int, int)>;
+    
+    explicit JobPool(int numWorkers_) : numWorkers(numWorkers_), queues(size_t(numWorkers_)) { }
+    
+    // Blocks until all jobs have run
+    void run(int numJobs, const Job& job)
+    {
+        for (int i = 0; i < numJobs; ++i) {
+            queues[size_t(i % numWorkers)].jobs.push_back(i);
+        }
+        
+        std::vector<std::thread> threads;
+        for (int w = 0; w < numWorkers; ++w) {
+            threads.emplace_back([this, w, &job]
+            {
+                int index;
+                while (take(w, index)) {
+                    job(w, index);
+                }
+            });
+        }
+        
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    
+private:
+    struct Queue
+    {
+        std::mutex lock;
+        std::deque<int> jobs;
+    };
+    
+    bool take(int worker, int& index)
+    {
+        // Own queue first, from the front
+        {
+            auto& queue = queues[size_t(worker)];
+            std::lock_guard<std::mutex> guard(queue.lock);
+            if (!queue.jobs.empty()) {
+                index = queue.jobs.front();
+                queue.jobs.pop_front();
+                return true;
+            }
+        }
+        
+        // Then steal from the back of the others, starting with the neighbour
+        for (int offset = 1; offset < numWorkers; ++offset) {
+            auto& queue = queues[size_t((worker + offset) % numWorkers)];
+            std::lock_guard<std::mutex> guard(queue.lock);
+            if (!queue.jobs.empty()) {
+                index = queue.jobs.back();
+                queue.jobs.pop_back();
+                return true;
+            }
+        }
+        
+        // Nothing is ever added while running, so empty everywhere means done
+        return false;
+    }
+    
+    int numWorkers;
+    std::vector<Queue> queues;
+};
@@ -0,0 +1,188 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 27 Oct 2026 10:12:40am
+    Author:  Edmund í Garði
+
+    Parallel batch renderer. Renders every audio file in a folder (or every
+    path listed in a text file) through its own processor instance, one file
+    per job on a work-stealing pool.
+
+        BatchRender inputs outputDir [--jobs N] [--preset name|index]
+                    [--state file] [--sample-rate 48000] [--format wav]
+                    [--bits 24] [--block-size 4096]
+                    [--tail-threshold -90] [--max-tail 30]
+
+    Each worker owns one processor that is created and prepared up front at
+    --sample-rate, so the delay lines are allocated once per worker instead
+    of once per file. Each worker also has its own reader and writer
+    threads, which keeps the read-ahead per file bounded.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Common/FileRenderer.h"
+#include "JobPool.h"
+
+//==============================================================================
+struct Worker
+{
+    explicit Worker(int index)
+        : readThread("Batch reader " + juce::String(index)),
+          writeThread("Batch writer " + juce::String(index))
+    {
+        formats.registerBasicFormats();
+        readThread.startThread();
+        writeThread.startThread();
+    }
+    
+    DddelayyyAudioProcessor processor;
+    juce::AudioFormatManager formats;
+    juce::TimeSliceThread readThread;
+    juce::TimeSliceThread writeThread;
+    
+    double audioSeconds = 0.0;
+    double busySeconds = 0.0;
+    int files = 0;
+};
+
+static juce::Array<juce::File> findInputs(const juce::File& inputs)
+{
+    juce::Array<juce::File> files;
+    
+    if (inputs.isDirectory()) {
+        files = inputs.findChildFiles(juce::File::findFiles, false, "*.wav;*.aif;*.aiff;*.flac");
+        files.sort();
+    } else {
+        juce::StringArray lines;
+        inputs.readLines(lines);
+        for (auto& line : lines) {
+            if (line.trim().isNotEmpty()) {
+                files.add(inputs.getParentDirectory().getChildFile(line.trim()));
+            }
+        }
+    }
+    return files;
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+    
+    if (args.size() < 2 || args[0].isOption() || args[1].isOption()) {
+        std::cerr << "Usage: BatchRender inputs outputDir [--jobs N] [--preset name|index] [--state file] "
+                     "[--sample-rate 48000] [--format wav] [--bits 24] [--block-size 4096] "
+                     "[--tail-threshold -90] [--max-tail 30]" << std::endl;
+        return 2;
+    }
+    
+    auto inputs = findInputs(args[0].resolveAsFile());
+    auto outputDir = args[1].resolveAsFile();
+    if (!outputDir.createDirectory()) {
+        std::cerr << "Could not create " << outputDir.getFullPathName() << std::endl;
+        return 1;
+    }
+    
+    int numWorkers = juce::SystemStats::getNumCpus();
+    if (args.containsOption("--jobs")) {
+        numWorkers = std::max(1, args.getValueForOption("--jobs").getIntValue());
+    }
+    numWorkers = std::min(numWorkers, std::max(1, inputs.size()));
+    
+    double sampleRate = 48000.0;
+    if (args.containsOption("--sample-rate")) {
+        sampleRate = args.getValueForOption("--sample-rate").getDoubleValue();
+    }
+    
+    auto extension = args.containsOption("--format") ? "." + args.getValueForOption("--format") : juce::String();
+    
+    FileRenderer::Settings settings;
+    if (args.containsOption("--bits")) {
+        settings.bits = args.getValueForOption("--bits").getIntValue();
+    }
+    if (args.containsOption("--block-size")) {
+        settings.blockSize = args.getValueForOption("--block-size").getIntValue();
+    }
+    if (args.containsOption("--tail-threshold")) {
+        settings.tailThreshold = juce::Decibels::decibelsToGain(args.getValueForOption("--tail-threshold").getFloatValue());
+    }
+    if (args.containsOption("--max-tail")) {
+        settings.maxTail = args.getValueForOption("--max-tail").getDoubleValue();
+    }
+    
+    // Workers are built and warmed on the main thread; the processors'
+    // parameter machinery expects to be created where the message loop lives
+    auto stateFile = args.containsOption("--state") ? args.getFileForOption("--state") : juce::File();
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int w = 0; w < numWorkers; ++w) {
+        auto worker = std::make_unique<Worker>(w);
+        
+        auto error = FileRenderer::applySettings(worker->processor, args.getValueForOption("--preset"), stateFile);
+        if (error.isNotEmpty()) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        
+        worker->processor.setNonRealtime(true);
+        worker->processor.setRateAndBufferSizeDetails(sampleRate, settings.blockSize);
+        worker->processor.prepareToPlay(sampleRate, settings.blockSize);
+        workers.push_back(std::move(worker));
+    }
+    
+    std::mutex printLock;
+    std::atomic<int> failures { 0 };
+    auto startTime = juce::Time::getMillisecondCounterHiRes();
+    
+    JobPool pool(numWorkers);
+    pool.run(inputs.size(), [&](int w, int index)
+    {
+        auto& worker = *workers[size_t(w)];
+        auto& input = inputs.getReference(index);
+        auto output = outputDir.getChildFile(input.getFileNameWithoutExtension()
+                                             + (extension.isEmpty() ? input.getFileExtension() : extension));
+        
+        auto result = FileRenderer::render(worker.processor, worker.formats, input, output, settings,
+                                           worker.readThread, worker.writeThread);
+        
+        worker.files += 1;
+        worker.audioSeconds += result.audioSeconds;
+        worker.busySeconds += result.wallSeconds;
+        
+        std::lock_guard<std::mutex> guard(printLock);
+        if (result.ok) {
+            std::cout << "ok\t" << input.getFileName()
+                      << "\t" << juce::String(result.audioSeconds, 2) << " s"
+                      << "\t" << juce::String(result.wallSeconds, 2) << " s"
+                      << "\t" << juce::String(result.audioSeconds / result.wallSeconds, 1) << "x"
+                      << "\tworker " << w
+                      << (result.tailCut ? "\ttail cut" : "") << std::endl;
+        } else {
+            failures += 1;
+            std::cout << "FAIL\t" << input.getFileName() << "\t" << result.error << std::endl;
+        }
+    });
+    
+    double wallSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+    double audioSeconds = 0.0;
+    
+    for (int w = 0; w < numWorkers; ++w) {
+        auto& worker = *workers[size_t(w)];
+        worker.processor.releaseResources();
+        audioSeconds += worker.audioSeconds;
+        
+        std::cout << "worker " << w << ": " << worker.files << " files, "
+                  << juce::String(worker.audioSeconds, 1) << " s of audio, busy "
+                  << juce::String(100.0 * worker.busySeconds / wallSeconds, 0) << " %" << std::endl;
+    }
+    
+    std::cout << inputs.size() << " files, " << failures.load() << " failed, "
+              << juce::String(audioSeconds, 1) << " s of audio in " << juce::String(wallSeconds, 2) << " s on "
+              << numWorkers << " workers: " << juce::String(audioSeconds / wallSeconds, 1) << "x realtime, "
+              << juce::String(double(inputs.size()) / wallSeconds, 2) << " files/s" << std::endl;
+    
+    return failures.load() == 0 ? 0 : 1;
+}
@@ -0,0 +1,296 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 22 Oct 2026 10:03:51am
+    Author:  Edmund í Garði
+
+    Headless processBlock benchmark. Sweeps sample rates, block sizes,
+    channel layouts and parameter states, and writes one JSON record per
+    combination:
+
+        Benchmark [--rates 44100,48000,...] [--blocks 16,64,...]
+                  [--layouts mono,mono-stereo,stereo] [--states default,...]
+                  [--seconds 2] [--output results.json]
+                  [--trace trace.json]
+
+    --trace needs the Profile configuration (make CONFIG=Profile), which
+    builds the processor with DDDELAYYY_PROFILING. It writes every measured
+    block with its stages as a Chrome trace for ui.perfetto.dev, and each
+    record gets the mean time per stage. The stage timing itself costs a
+    little, so compare timings from Profile builds only with each other.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Common/Harness.h"
+#include "../../Common/AllocationCounter.h"
+
+//==============================================================================
+struct Layout
+{
+    juce::String name;
+    juce::AudioChannelSet input, output;
+};
+
+struct ParameterState
+{
+    juce::String name;
+    std::vector<std::pair<juce::ParameterID, float>> values;
+};
+
+static std::vector<Layout> allLayouts()
+{
+    return {
+        { "mono", juce::AudioChannelSet::mono(), juce::AudioChannelSet::mono() },
+        { "mono-stereo", juce::AudioChannelSet::mono(), juce::AudioChannelSet::stereo() },
+        { "stereo", juce::AudioChannelSet::stereo(), juce::AudioChannelSet::stereo() },
+    };
+}
+
+static std::vector<ParameterState> allStates()
+{
+    return {
+        { "default", {} },
+        { "feedback", { { feedbackParamID, 90.0f }, { mixParamID, 50.0f } } },
+        { "tempoSync", { { tempoSyncParamID, 1.0f }, { delayNoteParamID, 8.0f }, { feedbackParamID, 60.0f } } },
+        { "full", { { feedbackParamID, 70.0f }, { driveParamID, 60.0f }, { diffuseParamID, 80.0f },
+                    { oversamplingParamID, 2.0f }, { lowCutParamID, 200.0f }, { highCutParamID, 5000.0f } } },
+    };
+}
+
+// Filters the full list by a comma separated option, or keeps it all
+template<typename T>
+static std::vector<T> select(const std::vector<T>& all, const juce::String& option)
+{
+    if (option.isEmpty()) { return all; }
+    
+    auto names = juce::StringArray::fromTokens(option, ",", "");
+    std::vector<T> result;
+    for (auto& item : all) {
+        if (names.contains(item.name)) {
+            result.push_back(item);
+        }
+    }
+    return result;
+}
+
+static std::vector<int> parseList(const juce::String& option, std::vector<int> fallback)
+{
+    if (option.isEmpty()) { return fallback; }
+    
+    std::vector<int> result;
+    for (auto& token : juce::StringArray::fromTokens(option, ",", "")) {
+        result.push_back(token.getIntValue());
+    }
+    return result;
+}
+
+//==============================================================================
+// Noise bursts over a slow sine, so the delay and the meters see both
+// transients and steady signal
+static juce::AudioBuffer<float> makeSignal(double sampleRate)
+{
+    int length = int(sampleRate);
+    juce::AudioBuffer<float> signal(2, length);
+    juce::Random random(1234);
+    
+    for (int i = 0; i < length; ++i) {
+        float sine = 0.25f * std::sin(juce::MathConstants<float>::twoPi * 220.0f * float(i) / float(sampleRate));
+        bool burst = (i % (length / 4)) < length / 40;
+        for (int ch = 0; ch < 2; ++ch) {
+            float noise = burst ? random.nextFloat() - 0.5f : 0.0f;
+            signal.setSample(ch, i, sine + noise);
+        }
+    }
+    return signal;
+}
+
+static double percentile(std::vector<double> values, double p)
+{
+    if (values.empty()) { return 0.0; }
+    
+    auto index = size_t(p * double(values.size() - 1) + 0.5);
+    std::nth_element(values.begin(), values.begin() + std::ptrdiff_t(index), values.end());
+    return values[index];
+}
+
+static juce::var run(double sampleRate, int blockSize, const Layout& layout, const ParameterState& state, double seconds,
+                     [[maybe_unused]] ProfileTrace* trace)
+{
+    DddelayyyAudioProcessor processor;
+    
+    juce::AudioProcessor::BusesLayout buses;
+    buses.inputBuses.add(layout.input);
+    buses.outputBuses.add(layout.output);
+    if (!processor.setBusesLayout(buses)) { return {}; }
+    
+    for (auto& [id, value] : state.values) {
+        Harness::setParameter(processor, id, value);
+    }
+    
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+    
+    auto signal = makeSignal(sampleRate);
+    juce::AudioBuffer<float> buffer(std::max(layout.input.size(), layout.output.size()), blockSize);
+    juce::MidiBuffer midi;
+    int position = 0;
+    
+    auto processNextBlock = [&]
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+            for (int i = 0; i < blockSize; ++i) {
+                buffer.setSample(ch, i, signal.getSample(ch % 2, (position + i) % signal.getNumSamples()));
+            }
+        }
+        position = (position + blockSize) % signal.getNumSamples();
+        
+        auto start = juce::Time::getHighResolutionTicks();
+        processor.processBlock(buffer, midi);
+        return juce::Time::getHighResolutionTicks() - start;
+    };
+    
+    // Half a second to fill the delay line and settle the smoothers
+    int warmupBlocks = int(0.5 * sampleRate) / blockSize + 1;
+    for (int b = 0; b < warmupBlocks; ++b) {
+        processNextBlock();
+    }
+    
+    int numBlocks = std::max(int(seconds * sampleRate) / blockSize, 64);
+    std::vector<double> nsPerSample;
+    nsPerSample.reserve(size_t(numBlocks));
+    double totalSeconds = 0.0;
+    
+   #if DDDELAYYY_PROFILING
+    // Leave the warmup out of the trace and the stage statistics
+    Profiler::Frame frame;
+    while (processor.profiler.popFrame(frame)) { }
+    
+    std::array<Profiler::Snapshot, Profiler::numStages + 1> before;
+    for (int stage = 0; stage <= Profiler::numStages; ++stage) {
+        before[size_t(stage)] = processor.profiler.snapshot(stage);
+    }
+    
+    if (trace != nullptr) {
+        trace->beginRun(juce::String(sampleRate) + " Hz, " + juce::String(blockSize) + " samples, "
+                        + layout.name + ", " + state.name);
+    }
+   #endif
+    
+    AllocationCounter::start();
+    for (int b = 0; b < numBlocks; ++b) {
+        double elapsed = juce::Time::highResolutionTicksToSeconds(processNextBlock());
+        totalSeconds += elapsed;
+        nsPerSample.push_back(elapsed * 1e9 / double(blockSize));
+        
+       #if DDDELAYYY_PROFILING
+        if (trace != nullptr) {
+            trace->collect(processor.profiler);
+        }
+       #endif
+    }
+    auto allocations = AllocationCounter::stop();
+    
+    processor.releaseResources();
+    
+    double processedSeconds = double(numBlocks) * double(blockSize) / sampleRate;
+    
+    auto* result = new juce::DynamicObject();
+    result->setProperty("sampleRate", sampleRate);
+    result->setProperty("blockSize", blockSize);
+    result->setProperty("layout", layout.name);
+    result->setProperty("state", state.name);
+    result->setProperty("blocks", numBlocks);
+    result->setProperty("nsPerSample", totalSeconds * 1e9 / (double(numBlocks) * double(blockSize)));
+    result->setProperty("p50", percentile(nsPerSample, 0.5));
+    result->setProperty("p90", percentile(nsPerSample, 0.9));
+    result->setProperty("p99", percentile(nsPerSample, 0.99));
+    result->setProperty("max", percentile(nsPerSample, 1.0));
+    result->setProperty("realtimeFactor", processedSeconds / totalSeconds);
+    result->setProperty("allocations", juce::int64(allocations.allocations));
+    result->setProperty("allocatedBytes", juce::int64(allocations.bytes));
+    
+   #if DDDELAYYY_PROFILING
+    auto* stages = new juce::DynamicObject();
+    for (int stage = 0; stage <= Profiler::numStages; ++stage) {
+        auto statistics = processor.profiler.summarize(processor.profiler.snapshot(stage), before[size_t(stage)]);
+        stages->setProperty(Profiler::getStageName(stage), statistics.mean * 1000.0 / double(blockSize));
+    }
+    result->setProperty("stageNsPerSample", stages);
+   #endif
+    return result;
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+    
+    auto rates = parseList(args.getValueForOption("--rates"), { 44100, 48000, 88200, 96000, 176400, 192000 });
+    auto blocks = parseList(args.getValueForOption("--blocks"), { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192 });
+    auto layouts = select(allLayouts(), args.getValueForOption("--layouts"));
+    auto states = select(allStates(), args.getValueForOption("--states"));
+    
+    double seconds = 2.0;
+    if (args.containsOption("--seconds")) {
+        seconds = args.getValueForOption("--seconds").getDoubleValue();
+    }
+    
+   #if DDDELAYYY_PROFILING
+    ProfileTrace trace;
+    auto* tracePointer = args.containsOption("--trace") ? &trace : nullptr;
+   #else
+    ProfileTrace* tracePointer = nullptr;
+    if (args.containsOption("--trace")) {
+        std::cerr << "--trace needs a build with DDDELAYYY_PROFILING, use the Profile configuration" << std::endl;
+        return 2;
+    }
+   #endif
+    
+    juce::Array<juce::var> results;
+    
+    for (int rate : rates) {
+        for (int blockSize : blocks) {
+            for (auto& layout : layouts) {
+                for (auto& state : states) {
+                    std::cerr << rate << " Hz, " << blockSize << " samples, "
+                              << layout.name << ", " << state.name << std::endl;
+                    
+                    auto result = run(double(rate), blockSize, layout, state, seconds, tracePointer);
+                    if (!result.isVoid()) {
+                        results.add(result);
+                    }
+                }
+            }
+        }
+    }
+    
+    auto* report = new juce::DynamicObject();
+    report->setProperty("plugin", JucePlugin_Name);
+    report->setProperty("build", juce::String(__DATE__) + " " + __TIME__);
+    report->setProperty("profiling", DDDELAYYY_PROFILING != 0);
+    report->setProperty("results", results);
+    
+    auto json = juce::JSON::toString(juce::var(report));
+    
+    if (args.containsOption("--output")) {
+        auto file = args.getFileForOption("--output");
+        if (!file.replaceWithText(json)) {
+            std::cerr << "Could not write " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+    } else {
+        std::cout << json << std::endl;
+    }
+    
+   #if DDDELAYYY_PROFILING
+    if (tracePointer != nullptr && !trace.write(args.getFileForOption("--trace"))) {
+        std::cerr << "Could not write the trace" << std::endl;
+        return 1;
+    }
+   #endif
+    return 0;
+}
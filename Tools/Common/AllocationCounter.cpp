@@ -0,0 +1,146 @@
+/*
+  ==============================================================================
+
+    AllocationCounter.cpp
+    Created: 22 Oct 2026 10:03:51am
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#include "AllocationCounter.h"
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+static thread_local bool counting = false;
+static thread_local AllocationCounter::Counts counts;
+
+void AllocationCounter::start() noexcept
+{
+    counts = {};
+    counting = true;
+}
+
+AllocationCounter::Counts AllocationCounter::stop() noexcept
+{
+    counting = false;
+    return counts;
+}
+
+static void count(std::size_t size) noexcept
+{
+    if (counting) {
+        counts.allocations += 1;
+        counts.bytes += size;
+    }
+}
+
+#if defined(__linux__) && defined(__GLIBC__)
+
+#include <cerrno>
+
+//==============================================================================
+// HeapBlock, AudioBuffer and most JUCE containers call malloc and realloc
+// directly, so the allocator itself is replaced, like RealtimeChecker does.
+// Operator new ends up here too.
+extern "C" void* __libc_malloc(std::size_t);
+extern "C" void* __libc_calloc(std::size_t, std::size_t);
+extern "C" void* __libc_realloc(void*, std::size_t);
+extern "C" void* __libc_memalign(std::size_t, std::size_t);
+
+extern "C" void* malloc(std::size_t size)
+{
+    count(size);
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(std::size_t number, std::size_t size)
+{
+    count(number * size);
+    return __libc_calloc(number, size);
+}
+
+extern "C" void* realloc(void* p, std::size_t size)
+{
+    // Shrinking to nothing is a free
+    if (size > 0) {
+        count(size);
+    }
+    return __libc_realloc(p, size);
+}
+
+extern "C" void* aligned_alloc(std::size_t alignment, std::size_t size)
+{
+    count(size);
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" void* memalign(std::size_t alignment, std::size_t size)
+{
+    count(size);
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void** result, std::size_t alignment, std::size_t size)
+{
+    count(size);
+    *result = __libc_memalign(alignment, size);
+    return *result != nullptr || size == 0 ? 0 : ENOMEM;
+}
+
+#else
+
+//==============================================================================
+// Elsewhere only operator new is replaced, so allocations that go straight
+// to malloc are not counted
+static void* allocate(std::size_t size, std::size_t alignment = 0) noexcept
+{
+    count(size);
+    
+    if (size == 0) { size = 1; }
+    
+    if (alignment > alignof(std::max_align_t)) {
+        // aligned_alloc wants the size to be a multiple of the alignment
+        return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    }
+    return std::malloc(size);
+}
+
+void* operator new(std::size_t size)
+{
+    if (void* p = allocate(size)) { return p; }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    if (void* p = allocate(size)) { return p; }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (void* p = allocate(size, std::size_t(alignment))) { return p; }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    if (void* p = allocate(size, std::size_t(alignment))) { return p; }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+#endif
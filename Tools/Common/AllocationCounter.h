@@ -0,0 +1,34 @@
+/*
+  ==============================================================================
+
+    AllocationCounter.h
+    Created: 22 Oct 2026 10:03:51am
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+
+//==============================================================================
+/*
+    Counts heap allocations made by the calling thread between start() and
+    stop(). On Linux with glibc, linking AllocationCounter.cpp replaces
+    malloc and its relatives, which operator new goes through as well.
+    Elsewhere it replaces only operator new and delete, and direct malloc
+    calls go uncounted. Only add it to tools, never to the plug-in, and not
+    together with RealtimeChecker.cpp, which replaces malloc too.
+*/
+namespace AllocationCounter
+{
+    struct Counts
+    {
+        std::uint64_t allocations = 0;
+        std::uint64_t bytes = 0;
+    };
+    
+    void start() noexcept;
+    Counts stop() noexcept;
+}
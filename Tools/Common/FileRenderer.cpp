@@ -0,0 +1,195 @@
+/*
+  ==============================================================================
+
+    FileRenderer.cpp
+    Created: 27 Oct 2026 10:12:40am
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#include "FileRenderer.h"
+
+juce::String FileRenderer::applySettings(DddelayyyAudioProcessor& processor, const juce::String& preset, const juce::File& stateFile)
+{
+    if (preset.isNotEmpty()) {
+        int index = -1;
+        for (int i = 0; i < processor.getNumPrograms(); ++i) {
+            if (processor.getProgramName(i).equalsIgnoreCase(preset)) {
+                index = i;
+            }
+        }
+        if (index < 0 && preset.containsOnly("0123456789")) {
+            index = preset.getIntValue();
+        }
+        if (index < 0 || index >= processor.getNumPrograms()) {
+            return "Unknown preset " + preset;
+        }
+        processor.setCurrentProgram(index);
+    }
+    
+    if (stateFile != juce::File()) {
+        juce::MemoryBlock state;
+        if (!stateFile.loadFileAsData(state)) {
+            return "Could not read " + stateFile.getFullPathName();
+        }
+        processor.setStateInformation(state.getData(), int(state.getSize()));
+    }
+    return {};
+}
+
+// Buffers output after the input has ended and only lets it through when
+// something audible follows, so the file ends where the echoes do
+class TailTrimmer
+{
+public:
+    TailTrimmer(juce::AudioFormatWriter::ThreadedWriter& writer_, int numChannels, int windowSize)
+        : writer(writer_), held(numChannels, windowSize) { }
+    
+    void write(const juce::AudioBuffer<float>& block, int numSamples)
+    {
+        writeNow(held, heldSamples);
+        heldSamples = 0;
+        writeNow(block, numSamples);
+    }
+    
+    // Returns false once the silence has lasted the whole window
+    bool hold(const juce::AudioBuffer<float>& block, int numSamples)
+    {
+        int count = std::min(numSamples, held.getNumSamples() - heldSamples);
+        for (int ch = 0; ch < held.getNumChannels(); ++ch) {
+            held.copyFrom(ch, heldSamples, block, ch, 0, count);
+        }
+        heldSamples += count;
+        return heldSamples < held.getNumSamples();
+    }
+    
+private:
+    void writeNow(const juce::AudioBuffer<float>& buffer, int numSamples)
+    {
+        // The writer's FIFO is full when the disk falls behind; wait for it
+        while (numSamples > 0 && !writer.write(buffer.getArrayOfReadPointers(), numSamples)) {
+            juce::Thread::sleep(1);
+        }
+    }
+    
+    juce::AudioFormatWriter::ThreadedWriter& writer;
+    juce::AudioBuffer<float> held;
+    int heldSamples = 0;
+};
+
+FileRenderer::Result FileRenderer::render(DddelayyyAudioProcessor& processor,
+                                          juce::AudioFormatManager& formats,
+                                          const juce::File& input,
+                                          const juce::File& output,
+                                          const Settings& settings,
+                                          juce::TimeSliceThread& readThread,
+                                          juce::TimeSliceThread& writeThread)
+{
+    Result result;
+    auto startTime = juce::Time::getMillisecondCounterHiRes();
+    
+    auto* fileReader = formats.createReaderFor(input);
+    if (fileReader == nullptr) {
+        result.error = "Could not open " + input.getFullPathName();
+        return result;
+    }
+    
+    double sampleRate = fileReader->sampleRate;
+    int inputChannels = int(fileReader->numChannels);
+    auto inputLength = fileReader->lengthInSamples;
+    int blockSize = settings.blockSize;
+    
+    // The reader stays a few blocks ahead of the DSP and no further
+    juce::BufferingAudioReader reader(fileReader, readThread, blockSize * 4);
+    reader.setReadTimeout(-1);
+    
+    auto* format = formats.findFormatForFileExtension(output.getFileExtension());
+    if (format == nullptr) {
+        result.error = "Unsupported output format " + output.getFileExtension();
+        return result;
+    }
+    
+    output.deleteFile();
+    auto stream = output.createOutputStream();
+    if (stream == nullptr) {
+        result.error = "Could not create " + output.getFullPathName();
+        return result;
+    }
+    
+    // The delay is stereo; mono files go in on one channel and come out wide
+    const int outputChannels = 2;
+    auto* fileWriter = format->createWriterFor(stream.get(), sampleRate, juce::uint32(outputChannels), settings.bits, {}, 0);
+    if (fileWriter == nullptr) {
+        result.error = "The output format does not support " + juce::String(settings.bits) + " bits at this sample rate";
+        return result;
+    }
+    stream.release();
+    
+    juce::AudioFormatWriter::ThreadedWriter writer(fileWriter, writeThread, blockSize * 8);
+    
+    juce::AudioProcessor::BusesLayout buses;
+    buses.inputBuses.add(inputChannels == 1 ? juce::AudioChannelSet::mono() : juce::AudioChannelSet::stereo());
+    buses.outputBuses.add(juce::AudioChannelSet::stereo());
+    if (buses != processor.getBusesLayout()) {
+        processor.releaseResources();
+        processor.setBusesLayout(buses);
+    }
+    
+    processor.setNonRealtime(true);
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+    
+    juce::AudioBuffer<float> block(outputChannels, blockSize);
+    juce::MidiBuffer midi;
+    
+    // Everything fades out within one maximum delay of silence at most,
+    // unless the feedback is at 100 %
+    int silenceWindow = int(std::ceil((Parameters::maxDelayTime / 1000.0 + 0.1) * sampleRate));
+    TailTrimmer trimmer(writer, outputChannels, silenceWindow);
+    
+    juce::int64 position = 0;
+    juce::int64 tailSamples = 0;
+    juce::int64 maxTailSamples = juce::int64(settings.maxTail * sampleRate);
+    
+    while (true) {
+        int count = blockSize;
+        bool inTail = position >= inputLength;
+        
+        if (!inTail) {
+            count = int(std::min(juce::int64(blockSize), inputLength - position));
+        }
+        
+        block.setSize(outputChannels, count, false, false, true);
+        block.clear();
+        
+        if (!inTail) {
+            reader.read(&block, 0, count, position, true, inputChannels > 1);
+        }
+        
+        processor.processBlock(block, midi);
+        position += count;
+        
+        if (!inTail) {
+            trimmer.write(block, count);
+            continue;
+        }
+        
+        tailSamples += count;
+        if (block.getMagnitude(0, count) >= settings.tailThreshold) {
+            trimmer.write(block, count);
+        } else if (!trimmer.hold(block, count)) {
+            break;
+        }
+        
+        if (tailSamples >= maxTailSamples) {
+            result.tailCut = true;
+            break;
+        }
+    }
+    
+    result.ok = true;
+    result.audioSeconds = double(position) / sampleRate;
+    result.wallSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+    return result;
+}
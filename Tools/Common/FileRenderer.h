@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    FileRenderer.h
+    Created: 27 Oct 2026 10:12:40am
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+
+//==============================================================================
+/*
+    Streams one audio file through a processor and writes the result, echo
+    tail included. Reading and writing run on the given threads with bounded
+    buffers in between, so disk and DSP overlap without the memory use
+    growing with the file length.
+*/
+namespace FileRenderer
+{
+    struct Settings
+    {
+        int bits = 24;
+        int blockSize = 4096;
+        float tailThreshold = juce::Decibels::decibelsToGain(-90.0f);
+        double maxTail = 30.0;
+    };
+    
+    struct Result
+    {
+        bool ok = false;
+        juce::String error;
+        double audioSeconds = 0.0;
+        double wallSeconds = 0.0;
+        bool tailCut = false;
+    };
+    
+    // Loads a preset (by name or index) and then a saved state blob; either
+    // may be empty. Call it before the processor is prepared so the preset
+    // lands without a crossfade.
+    juce::String applySettings(DddelayyyAudioProcessor& processor, const juce::String& preset, const juce::File& stateFile);
+    
+    // Prepares the processor for the file's sample rate and layout; when
+    // they match the last file this only clears the delay lines
+    Result render(DddelayyyAudioProcessor& processor,
+                  juce::AudioFormatManager& formats,
+                  const juce::File& input,
+                  const juce::File& output,
+                  const Settings& settings,
+                  juce::TimeSliceThread& readThread,
+                  juce::TimeSliceThread& writeThread);
+}
@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+
+    Harness.h
+    Created: 24 Oct 2026 11:20:36am
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+
+//==============================================================================
+// Small helpers shared by the command-line tools that drive the processor
+namespace Harness
+{
+    // Sets a parameter from its plain value, the way a host would
+    inline void setParameter(DddelayyyAudioProcessor& processor, const juce::ParameterID& id, float value)
+    {
+        auto* parameter = processor.apvts.getParameter(id.getParamID());
+        jassert(parameter != nullptr);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+    
+    // A transport that always reports the same tempo, so tempo-synced
+    // renders don't depend on the 120 BPM fallback
+    class FixedPlayHead : public juce::AudioPlayHead
+    {
+    public:
+        explicit FixedPlayHead(double bpm_) : bpm(bpm_) { }
+        
+        juce::Optional<PositionInfo> getPosition() const override
+        {
+            PositionInfo info;
+            info.setBpm(bpm);
+            info.setIsPlaying(true);
+            return info;
+        }
+        
+    private:
+        double bpm;
+    };
+}
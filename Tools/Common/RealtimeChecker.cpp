@@ -0,0 +1,250 @@
+/*
+  ==============================================================================
+
+    RealtimeChecker.cpp
+    Created: 30 Oct 2026 9:12:53am
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#include "RealtimeChecker.h"
+#include <algorithm>
+#include <atomic>
+
+#if defined(__linux__) && defined(__GLIBC__)
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static thread_local int realtimeDepth = 0;
+static thread_local bool reporting = false;
+static std::atomic<std::uint64_t> violations { 0 };
+static std::atomic<int> maxReports { 10 };
+static std::atomic<int> numReports { 0 };
+
+// glibc's own allocator entry points, so the replacements below don't need
+// dlsym, which allocates itself
+extern "C" void* __libc_malloc(std::size_t);
+extern "C" void* __libc_calloc(std::size_t, std::size_t);
+extern "C" void* __libc_realloc(void*, std::size_t);
+extern "C" void* __libc_memalign(std::size_t, std::size_t);
+extern "C" void __libc_free(void*);
+
+// The first backtrace() loads libgcc, which must not happen inside a report
+static const bool backtraceLoaded = []
+{
+    void* frames[1];
+    return backtrace(frames, 1) >= 0;
+}();
+
+template<typename Function>
+static Function next(const char* name) noexcept
+{
+    return reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+}
+
+static void violation(const char* format, ...) noexcept
+{
+    if (realtimeDepth == 0 || reporting) { return; }
+    
+    violations.fetch_add(1);
+    if (numReports.fetch_add(1) >= maxReports.load()) { return; }
+    
+    // Anything the report itself calls is not the audio thread's fault
+    reporting = true;
+    
+    char message[256];
+    std::va_list args;
+    va_start(args, format);
+    int length = std::vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+    
+    static const char header[] = "\n*** Realtime violation: ";
+    ::write(STDERR_FILENO, header, sizeof(header) - 1);
+    ::write(STDERR_FILENO, message, size_t(std::min(length, int(sizeof(message)) - 1)));
+    ::write(STDERR_FILENO, "\n", 1);
+    
+    // Skip this function and the hook that called it
+    void* frames[64];
+    int numFrames = backtrace(frames, 64);
+    if (numFrames > 2) {
+        backtrace_symbols_fd(frames + 2, numFrames - 2, STDERR_FILENO);
+    }
+    
+    reporting = false;
+}
+
+//==============================================================================
+bool RealtimeChecker::isAvailable() noexcept { return backtraceLoaded; }
+
+void RealtimeChecker::enter() noexcept { realtimeDepth += 1; }
+void RealtimeChecker::exit() noexcept { realtimeDepth -= 1; }
+
+std::uint64_t RealtimeChecker::getNumViolations() noexcept { return violations.load(); }
+
+void RealtimeChecker::reset() noexcept
+{
+    violations.store(0);
+    numReports.store(0);
+}
+
+void RealtimeChecker::setMaxReports(int newMaxReports) noexcept { maxReports.store(newMaxReports); }
+
+//==============================================================================
+// Memory. Operator new and delete end up here too.
+extern "C" void* malloc(std::size_t size)
+{
+    violation("malloc(%zu)", size);
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(std::size_t count, std::size_t size)
+{
+    violation("calloc(%zu, %zu)", count, size);
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* p, std::size_t size)
+{
+    violation("realloc(%p, %zu)", p, size);
+    return __libc_realloc(p, size);
+}
+
+extern "C" void* aligned_alloc(std::size_t alignment, std::size_t size)
+{
+    violation("aligned_alloc(%zu, %zu)", alignment, size);
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" void* memalign(std::size_t alignment, std::size_t size)
+{
+    violation("memalign(%zu, %zu)", alignment, size);
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void** result, std::size_t alignment, std::size_t size)
+{
+    violation("posix_memalign(%zu, %zu)", alignment, size);
+    *result = __libc_memalign(alignment, size);
+    return *result != nullptr || size == 0 ? 0 : ENOMEM;
+}
+
+extern "C" void free(void* p)
+{
+    if (p != nullptr) {
+        violation("free(%p)", p);
+    }
+    __libc_free(p);
+}
+
+//==============================================================================
+// Locks and waits. Releasing a lock can wake another thread, which means a
+// system call, so unlock and signal count as well.
+// The real functions are looked up before main, since dlsym allocates
+#define REALTIME_HOOK(result, name, parameters, arguments, format, ...)    \
+    static result (*real_##name) parameters = next<result (*) parameters>(#name); \
+                                                                          \
+    extern "C" result name parameters                                     \
+    {                                                                     \
+        violation(#name format, __VA_ARGS__);                             \
+        if (real_##name == nullptr) {                                     \
+            real_##name = next<result (*) parameters>(#name);             \
+        }                                                                 \
+        return real_##name arguments;                                     \
+    }
+
+REALTIME_HOOK(int, pthread_mutex_lock, (pthread_mutex_t* m), (m), "(%p)", (void*) m)
+REALTIME_HOOK(int, pthread_mutex_trylock, (pthread_mutex_t* m), (m), "(%p)", (void*) m)
+REALTIME_HOOK(int, pthread_mutex_unlock, (pthread_mutex_t* m), (m), "(%p)", (void*) m)
+REALTIME_HOOK(int, pthread_rwlock_rdlock, (pthread_rwlock_t* l), (l), "(%p)", (void*) l)
+REALTIME_HOOK(int, pthread_rwlock_wrlock, (pthread_rwlock_t* l), (l), "(%p)", (void*) l)
+REALTIME_HOOK(int, pthread_rwlock_unlock, (pthread_rwlock_t* l), (l), "(%p)", (void*) l)
+REALTIME_HOOK(int, pthread_cond_wait, (pthread_cond_t* c, pthread_mutex_t* m), (c, m), "(%p)", (void*) c)
+REALTIME_HOOK(int, pthread_cond_timedwait, (pthread_cond_t* c, pthread_mutex_t* m, const timespec* t), (c, m, t), "(%p)", (void*) c)
+REALTIME_HOOK(int, pthread_cond_signal, (pthread_cond_t* c), (c), "(%p)", (void*) c)
+REALTIME_HOOK(int, pthread_cond_broadcast, (pthread_cond_t* c), (c), "(%p)", (void*) c)
+REALTIME_HOOK(int, pthread_join, (pthread_t t, void** r), (t, r), "(%lu)", (unsigned long) t)
+REALTIME_HOOK(int, sem_wait, (sem_t* s), (s), "(%p)", (void*) s)
+REALTIME_HOOK(int, sem_timedwait, (sem_t* s, const timespec* t), (s, t), "(%p)", (void*) s)
+
+//==============================================================================
+// System calls that block or touch the file system
+REALTIME_HOOK(ssize_t, read, (int fd, void* buffer, size_t size), (fd, buffer, size), "(%d, %zu)", fd, size)
+REALTIME_HOOK(ssize_t, write, (int fd, const void* buffer, size_t size), (fd, buffer, size), "(%d, %zu)", fd, size)
+REALTIME_HOOK(int, close, (int fd), (fd), "(%d)", fd)
+REALTIME_HOOK(int, fsync, (int fd), (fd), "(%d)", fd)
+REALTIME_HOOK(unsigned int, sleep, (unsigned int seconds), (seconds), "(%u)", seconds)
+REALTIME_HOOK(int, usleep, (useconds_t microseconds), (microseconds), "(%u)", unsigned(microseconds))
+REALTIME_HOOK(int, nanosleep, (const timespec* t, timespec* r), (t, r), "(%p)", (const void*) t)
+REALTIME_HOOK(int, clock_nanosleep, (clockid_t c, int f, const timespec* t, timespec* r), (c, f, t, r), "(%d)", int(c))
+REALTIME_HOOK(int, sched_yield, (), (), "%s", "")
+REALTIME_HOOK(int, poll, (pollfd* fds, nfds_t n, int timeout), (fds, n, timeout), "(%d)", timeout)
+REALTIME_HOOK(int, select, (int n, fd_set* r, fd_set* w, fd_set* e, timeval* t), (n, r, w, e, t), "(%d)", n)
+REALTIME_HOOK(ssize_t, send, (int fd, const void* buffer, size_t size, int flags), (fd, buffer, size, flags), "(%d, %zu)", fd, size)
+REALTIME_HOOK(ssize_t, recv, (int fd, void* buffer, size_t size, int flags), (fd, buffer, size, flags), "(%d, %zu)", fd, size)
+REALTIME_HOOK(FILE*, fopen, (const char* path, const char* mode), (path, mode), "(%s)", path)
+
+// open takes a mode only when it creates the file
+static int (*real_open)(const char*, int, ...) = next<int (*)(const char*, int, ...)>("open");
+static int (*real_openat)(int, const char*, int, ...) = next<int (*)(int, const char*, int, ...)>("openat");
+
+extern "C" int open(const char* path, int flags, ...)
+{
+    violation("open(%s)", path);
+    
+    mode_t mode = 0;
+    if ((flags & O_CREAT) != 0 || (flags & O_TMPFILE) == O_TMPFILE) {
+        std::va_list args;
+        va_start(args, flags);
+        mode = mode_t(va_arg(args, int));
+        va_end(args);
+    }
+    
+    if (real_open == nullptr) {
+        real_open = next<int (*)(const char*, int, ...)>("open");
+    }
+    return real_open(path, flags, mode);
+}
+
+extern "C" int openat(int directory, const char* path, int flags, ...)
+{
+    violation("openat(%s)", path);
+    
+    mode_t mode = 0;
+    if ((flags & O_CREAT) != 0 || (flags & O_TMPFILE) == O_TMPFILE) {
+        std::va_list args;
+        va_start(args, flags);
+        mode = mode_t(va_arg(args, int));
+        va_end(args);
+    }
+    
+    if (real_openat == nullptr) {
+        real_openat = next<int (*)(int, const char*, int, ...)>("openat");
+    }
+    return real_openat(directory, path, flags, mode);
+}
+
+#else
+
+static std::atomic<std::uint64_t> violations { 0 };
+
+bool RealtimeChecker::isAvailable() noexcept { return false; }
+void RealtimeChecker::enter() noexcept { }
+void RealtimeChecker::exit() noexcept { }
+std::uint64_t RealtimeChecker::getNumViolations() noexcept { return violations.load(); }
+void RealtimeChecker::reset() noexcept { }
+void RealtimeChecker::setMaxReports(int) noexcept { }
+
+#endif
@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    RealtimeChecker.h
+    Created: 30 Oct 2026 9:12:53am
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+
+//==============================================================================
+/*
+    Catches calls that don't belong on the audio thread. Between enter() and
+    exit() the calling thread is in the realtime region. If that thread then
+    allocates or frees memory, takes or waits on a lock, sleeps, or does
+    file or socket I/O, the call is counted and reported on stderr with a
+    stack trace. The call itself still goes through.
+
+    Linking RealtimeChecker.cpp interposes malloc, free, the pthread lock
+    and wait functions and the blocking libc calls for the whole program, so
+    only add it to tools, never to the plug-in. It works on Linux with
+    glibc; elsewhere isAvailable() is false and nothing is checked. Link
+    with -rdynamic to get function names in the stack traces, or feed the
+    addresses to addr2line.
+*/
+namespace RealtimeChecker
+{
+    bool isAvailable() noexcept;
+    
+    // Mark the audio callback's entry and exit on the thread that runs it
+    void enter() noexcept;
+    void exit() noexcept;
+    
+    struct ScopedRealtime
+    {
+        ScopedRealtime() noexcept { enter(); }
+        ~ScopedRealtime() noexcept { exit(); }
+    };
+    
+    // Violations since the last reset, from every thread
+    std::uint64_t getNumViolations() noexcept;
+    void reset() noexcept;
+    
+    // Only the first few violations get a stack trace, the rest are counted
+    void setMaxReports(int maxReports) noexcept;
+}
@@ -0,0 +1,342 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 23 Oct 2026 9:47:12am
+    Author:  Edmund í Garði
+
+    Accuracy tests and micro-benchmarks for DelayLine.
+
+        DelayLineTest [--test] [--bench]
+
+    With no options it runs both. The exit code is non-zero if any accuracy
+    check fails, so it can gate changes to read() and write().
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/DelayLine.h"
+
+#include <chrono>
+#include <complex>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+//==============================================================================
+static int failures = 0;
+
+static void check(bool ok, const char* what, double value, double limit)
+{
+    if (!ok) {
+        failures += 1;
+    }
+    std::printf("  %-4s %-48s %12.6g  (limit %g)\n", ok ? "ok" : "FAIL", what, value, limit);
+}
+
+static constexpr double pi = 3.14159265358979323846;
+
+// Blackman-Harris windowed sinc, long enough that its own error is far
+// below anything the interpolator could reach
+static constexpr int sincHalfWidth = 64;
+
+static double windowedSinc(double t)
+{
+    if (std::abs(t) >= double(sincHalfWidth)) { return 0.0; }
+    
+    double sinc = t == 0.0 ? 1.0 : std::sin(pi * t) / (pi * t);
+    double phase = pi * (t + double(sincHalfWidth)) / double(sincHalfWidth);
+    double window = 0.35875 - 0.48829 * std::cos(phase) + 0.14128 * std::cos(2.0 * phase) - 0.01168 * std::cos(3.0 * phase);
+    return sinc * window;
+}
+
+// The signal x delayed by delay samples, evaluated at index n
+static double sincReference(const std::vector<double>& x, int n, double delay)
+{
+    int integerDelay = int(delay);
+    double sum = 0.0;
+    for (int k = integerDelay - sincHalfWidth; k <= integerDelay + sincHalfWidth; ++k) {
+        int index = n - k;
+        if (index >= 0 && index < int(x.size())) {
+            sum += x[size_t(index)] * windowedSinc(double(k) - delay);
+        }
+    }
+    return sum;
+}
+
+// White noise low-passed at a quarter of the sample rate, the band a
+// delay's interpolator is expected to get right
+static std::vector<double> bandLimitedNoise(int length, double cutoff)
+{
+    std::mt19937 random(42);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    
+    std::vector<double> white(size_t(length + 2 * sincHalfWidth));
+    for (auto& sample : white) {
+        sample = uniform(random);
+    }
+    
+    std::vector<double> result(size_t(length), 0.0);
+    for (int n = 0; n < length; ++n) {
+        double sum = 0.0;
+        for (int k = -sincHalfWidth; k <= sincHalfWidth; ++k) {
+            sum += white[size_t(n + sincHalfWidth + k)] * 2.0 * cutoff * windowedSinc(2.0 * cutoff * double(k));
+        }
+        result[size_t(n)] = sum;
+    }
+    return result;
+}
+
+// The same four-point Hermite as DelayLine::read, done on a plain history
+// array so there is no ring buffer to get wrong
+static float hermiteReference(const std::vector<float>& history, int n, float delayInSamples)
+{
+    int integerDelay = int(delayInSamples);
+    float sampleA = history[size_t(n - integerDelay + 1)];
+    float sampleB = history[size_t(n - integerDelay)];
+    float sampleC = history[size_t(n - integerDelay - 1)];
+    float sampleD = history[size_t(n - integerDelay - 2)];
+    
+    float fraction = delayInSamples - float(integerDelay);
+    float slope0 = (sampleC - sampleA) * 0.5f;
+    float slope1 = (sampleD - sampleB) * 0.5f;
+    float v = sampleB - sampleC;
+    float w = slope0 + v;
+    float a = w + v + slope1;
+    float b = w + a;
+    float stage1 = a * fraction - b;
+    float stage2 = stage1 * fraction + slope0;
+    return stage2 * fraction + sampleB;
+}
+
+//==============================================================================
+static void testIntegerDelays()
+{
+    std::printf("Integer delays are exact\n");
+    
+    const int maxDelay = 1000;
+    DelayLine delayLine;
+    delayLine.setMaximumDelayInSamples(maxDelay);
+    delayLine.reset();
+    
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    std::vector<float> history;
+    
+    double worst = 0.0;
+    for (int n = 0; n < 3 * delayLine.getBufferLength(); ++n) {
+        history.push_back(uniform(random));
+        delayLine.write(history.back());
+        
+        for (int delay = 1; delay <= std::min(n, maxDelay); ++delay) {
+            double error = std::abs(double(delayLine.read(float(delay))) - double(history[size_t(n - delay)]));
+            worst = std::max(worst, error);
+        }
+    }
+    check(worst == 0.0, "max error at integer delays", worst, 0.0);
+}
+
+static void testWraparound()
+{
+    std::printf("Reads across the wraparound point\n");
+    
+    // A tiny buffer so the write index wraps every few samples and every
+    // delay straddles the boundary at some point
+    const int maxDelay = 16;
+    DelayLine delayLine;
+    delayLine.setMaximumDelayInSamples(maxDelay);
+    delayLine.reset();
+    
+    std::mt19937 random(2);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    std::vector<float> history;
+    
+    float longest = float(delayLine.getBufferLength()) - 2.0f;
+    double worst = 0.0;
+    
+    for (int n = 0; n < 20 * delayLine.getBufferLength(); ++n) {
+        history.push_back(uniform(random));
+        delayLine.write(history.back());
+        
+        if (n < delayLine.getBufferLength()) { continue; }
+        
+        for (float delay = 1.0f; delay <= longest; delay += 0.125f) {
+            double error = std::abs(double(delayLine.read(delay)) - double(hermiteReference(history, n, delay)));
+            worst = std::max(worst, error);
+        }
+    }
+    check(worst < 1e-6, "max error against a linear history", worst, 1e-6);
+}
+
+static void testFrequencyResponse()
+{
+    std::printf("Frequency response against an ideal fractional delay\n");
+    std::printf("  %8s %8s %12s %14s\n", "freq/fs", "frac", "gain (dB)", "delay error");
+    
+    // Every test frequency fits a whole number of periods into the
+    // measured part, so nothing leaks in from the negative frequency
+    const int settle = 256;
+    const int length = settle + 8000;
+    const int integerDelay = 10;
+    
+    for (double fraction : { 0.25, 0.5, 0.75 }) {
+        for (double frequency : { 0.01, 0.05, 0.1, 0.2, 0.3, 0.4, 0.45 }) {
+            DelayLine delayLine;
+            delayLine.setMaximumDelayInSamples(integerDelay + 4);
+            delayLine.reset();
+            
+            double omega = 2.0 * pi * frequency;
+            float delay = float(integerDelay + fraction);
+            
+            // Correlate the output with the input phasor to get the complex response
+            std::complex<double> response = 0.0;
+            for (int n = 0; n < length; ++n) {
+                delayLine.write(float(std::sin(omega * double(n))));
+                double y = double(delayLine.read(delay));
+                if (n >= settle) {
+                    response += y * std::polar(1.0, -omega * double(n));
+                }
+            }
+            response *= 2.0 / double(length - settle);
+            
+            // The phasor of sin is -j
+            response /= std::complex<double>(0.0, -1.0);
+            
+            double gain = 20.0 * std::log10(std::abs(response));
+            double delayError = std::remainder(-std::arg(response) - omega * double(delay), 2.0 * pi) / omega;
+            
+            std::printf("  %8.3f %8.2f %12.4f %14.6f\n", frequency, fraction, gain, delayError);
+            
+            // The passband a delay effect cares about: up to a tenth of the
+            // sample rate the cubic must be close to flat and on time
+            if (frequency <= 0.1) {
+                check(std::abs(gain) < 0.1, "passband gain deviation (dB)", std::abs(gain), 0.1);
+                check(std::abs(delayError) < 0.01, "passband delay error (samples)", std::abs(delayError), 0.01);
+            }
+        }
+    }
+}
+
+static void testFractionalError(const char* name, bool lagrange, double minimumSnr)
+{
+    std::printf("%s error against a windowed-sinc reference, noise band-limited to fs/4\n", name);
+    std::printf("  %8s %12s\n", "frac", "SNR (dB)");
+    
+    const int length = 16384;
+    const int integerDelay = 100;
+    auto signal = bandLimitedNoise(length, 0.25);
+    
+    for (int step = 0; step <= 16; ++step) {
+        double fraction = double(step) / 16.0;
+        double delay = double(integerDelay) + fraction;
+        
+        DelayLine delayLine;
+        delayLine.setMaximumDelayInSamples(integerDelay + 4);
+        delayLine.reset();
+        
+        double signalPower = 0.0;
+        double errorPower = 0.0;
+        for (int n = 0; n < length; ++n) {
+            delayLine.write(float(signal[size_t(n)]));
+            double y = double(lagrange ? delayLine.readLagrange(float(delay)) : delayLine.read(float(delay)));
+            
+            // Stay clear of the edges where the reference runs out of input
+            if (n > integerDelay + 2 * sincHalfWidth && n < length - sincHalfWidth) {
+                double reference = sincReference(signal, n, delay);
+                signalPower += reference * reference;
+                errorPower += (y - reference) * (y - reference);
+            }
+        }
+        
+        double snr = 10.0 * std::log10(signalPower / std::max(errorPower, 1e-30));
+        std::printf("  %8.4f %12.2f\n", fraction, snr);
+        
+        // Both are at their worst halfway between samples, Hermite at
+        // about 28 dB and Lagrange at about 37
+        check(snr > minimumSnr, "SNR (dB)", snr, minimumSnr);
+    }
+}
+
+//==============================================================================
+template<typename DelayFunction>
+static void benchmark(const char* name, int maxDelay, DelayFunction delayForSample)
+{
+    const int numSamples = 1 << 24;
+    
+    DelayLine delayLine;
+    delayLine.setMaximumDelayInSamples(maxDelay);
+    delayLine.reset();
+    
+    // Run through the buffer once so every page is touched before timing
+    for (int n = 0; n < delayLine.getBufferLength(); ++n) {
+        delayLine.write(0.0f);
+    }
+    
+    float input = 0.0f;
+    float sum = 0.0f;
+    
+    auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < numSamples; ++n) {
+        delayLine.write(input);
+        float output = delayLine.read(delayForSample(n));
+        input = output * 0.5f + 1e-3f;
+        sum += output;
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    double nsPerSample = elapsed * 1e9 / double(numSamples);
+    std::printf("  %-10s %10d %10.0f kB %10.3f ns/sample %10.1f Msamples/s  (%g)\n",
+                name, maxDelay, double(delayLine.getBufferLength()) * sizeof(float) / 1024.0,
+                nsPerSample, 1e3 / nsPerSample, double(sum));
+}
+
+static void runBenchmarks()
+{
+    std::printf("Throughput, one write and one read per sample\n");
+    
+    // In L1, in L2 and well past the last-level cache
+    for (int maxDelay : { 1 << 10, 1 << 16, 1 << 22 }) {
+        float center = float(maxDelay) * 0.5f;
+        benchmark("constant", maxDelay, [center](int) { return center; });
+        
+        // A slow LFO sweeping most of the buffer, like a long chorus
+        float depth = float(maxDelay) * 0.4f;
+        float omega = 2.0f * float(pi) * 0.5f / 48000.0f;
+        benchmark("modulated", maxDelay, [center, depth, omega](int n) {
+            return center + depth * std::sin(omega * float(n));
+        });
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    bool runTests = true;
+    bool runBench = true;
+    
+    if (argc > 1) {
+        runTests = false;
+        runBench = false;
+        for (int i = 1; i < argc; ++i) {
+            runTests |= std::strcmp(argv[i], "--test") == 0;
+            runBench |= std::strcmp(argv[i], "--bench") == 0;
+        }
+    }
+    
+    if (runTests) {
+        testIntegerDelays();
+        testWraparound();
+        testFrequencyResponse();
+        testFractionalError("Hermite", false, 25.0);
+        testFractionalError("Lagrange", true, 34.0);
+        std::printf("%d failure(s)\n", failures);
+    }
+    
+    if (runBench) {
+        runBenchmarks();
+    }
+    
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,260 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 28 Oct 2026 2:05:17pm
+    Author:  Edmund í Garði
+
+    Multi-instance stress test. Builds an AudioProcessorGraph of N delay
+    instances, the way AudioPluginHostPresets/dddelayyy.filtergraph wires
+    one, and runs it headless under automation:
+
+        GraphStress [--instances 1,10,50,100,200,500]
+                    [--topologies series,parallel,mixed]
+                    [--sample-rate 48000] [--block-size 256]
+                    [--seconds 5] [--output results.json]
+
+    series    input -> 1 -> 2 -> ... -> N -> output
+    parallel  input -> each instance -> output, summed
+    mixed     about sqrt(N) parallel chains of sqrt(N) instances
+
+    For every run it reports the time per block and as a share of the
+    block's duration, the hardware counters when perf is available, and the
+    heap and resident memory per instance.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Common/Harness.h"
+#include "../../Common/AllocationCounter.h"
+#include "PerfCounters.h"
+
+#include <numeric>
+
+using Graph = juce::AudioProcessorGraph;
+using UpdateKind = Graph::UpdateKind;
+
+//==============================================================================
+static juce::int64 residentBytes()
+{
+   #if JUCE_LINUX
+    juce::StringArray fields;
+    fields.addTokens(juce::File("/proc/self/statm").loadFileAsString(), " ", "");
+    return fields[1].getLargeIntValue() * juce::int64(sysconf(_SC_PAGESIZE));
+   #else
+    return 0;
+   #endif
+}
+
+static void connectStereo(Graph& graph, Graph::NodeID source, Graph::NodeID destination)
+{
+    for (int ch = 0; ch < 2; ++ch) {
+        graph.addConnection({ { source, ch }, { destination, ch } }, UpdateKind::none);
+    }
+}
+
+struct Instances
+{
+    std::vector<DddelayyyAudioProcessor*> processors;
+};
+
+// Adds n instances and wires them up; returns raw pointers for automation
+static Instances build(Graph& graph, const juce::String& topology, int n)
+{
+    Instances instances;
+    
+    auto input = graph.addNode(std::make_unique<Graph::AudioGraphIOProcessor>(Graph::AudioGraphIOProcessor::audioInputNode), {}, UpdateKind::none);
+    auto output = graph.addNode(std::make_unique<Graph::AudioGraphIOProcessor>(Graph::AudioGraphIOProcessor::audioOutputNode), {}, UpdateKind::none);
+    
+    int numChains = 1;
+    if (topology == "parallel") {
+        numChains = n;
+    } else if (topology == "mixed") {
+        numChains = std::max(1, int(std::round(std::sqrt(double(n)))));
+    }
+    
+    for (int chain = 0; chain < numChains; ++chain) {
+        // Spread the instances as evenly as possible over the chains
+        int length = n / numChains + (chain < n % numChains ? 1 : 0);
+        auto previous = input->nodeID;
+        
+        for (int i = 0; i < length; ++i) {
+            auto processor = std::make_unique<DddelayyyAudioProcessor>();
+            auto* raw = processor.get();
+            
+            // A long series chain must not build up gain from stage to stage
+            Harness::setParameter(*raw, mixParamID, 20.0f);
+            Harness::setParameter(*raw, gainParamID, -1.6f);
+            Harness::setParameter(*raw, feedbackParamID, 40.0f);
+            
+            auto node = graph.addNode(std::move(processor), {}, UpdateKind::none);
+            connectStereo(graph, previous, node->nodeID);
+            previous = node->nodeID;
+            instances.processors.push_back(raw);
+        }
+        connectStereo(graph, previous, output->nodeID);
+    }
+    
+    graph.rebuild();
+    return instances;
+}
+
+// A few instances move a knob every block and now and then someone changes
+// the delay time, which is about what a busy mix session does
+static void automate(Instances& instances, juce::Random& random)
+{
+    int numChanges = std::max(1, int(instances.processors.size()) / 20);
+    for (int i = 0; i < numChanges; ++i) {
+        auto& processor = *instances.processors[size_t(random.nextInt(int(instances.processors.size())))];
+        switch (random.nextInt(10)) {
+            case 0:
+                Harness::setParameter(processor, delayTimeParamID, 50.0f + random.nextFloat() * 700.0f);
+                break;
+            case 1:
+            case 2:
+            case 3:
+                Harness::setParameter(processor, feedbackParamID, random.nextFloat() * 60.0f);
+                break;
+            default:
+                Harness::setParameter(processor, mixParamID, 10.0f + random.nextFloat() * 20.0f);
+                break;
+        }
+    }
+}
+
+static double percentile(std::vector<double> values, double p)
+{
+    if (values.empty()) { return 0.0; }
+    
+    auto index = size_t(p * double(values.size() - 1) + 0.5);
+    std::nth_element(values.begin(), values.begin() + std::ptrdiff_t(index), values.end());
+    return values[index];
+}
+
+static juce::var run(const juce::String& topology, int n, double sampleRate, int blockSize, double seconds)
+{
+    auto rssBefore = residentBytes();
+    AllocationCounter::start();
+    
+    auto graph = std::make_unique<Graph>();
+    graph->setPlayConfigDetails(2, 2, sampleRate, blockSize);
+    auto instances = build(*graph, topology, n);
+    graph->prepareToPlay(sampleRate, blockSize);
+    
+    auto heap = AllocationCounter::stop();
+    auto rssAfter = residentBytes();
+    
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::MidiBuffer midi;
+    juce::Random random(n);
+    PerfCounters counters;
+    
+    // Warm up for half a second so every delay line has been touched
+    int warmupBlocks = int(0.5 * sampleRate) / blockSize + 1;
+    int numBlocks = std::max(int(seconds * sampleRate) / blockSize, 32);
+    
+    std::vector<double> blockTimes;
+    blockTimes.reserve(size_t(numBlocks));
+    std::array<std::uint64_t, PerfCounters::numCounters> totals {};
+    
+    for (int b = 0; b < warmupBlocks + numBlocks; ++b) {
+        for (int ch = 0; ch < 2; ++ch) {
+            for (int i = 0; i < blockSize; ++i) {
+                buffer.setSample(ch, i, (random.nextFloat() - 0.5f) * 0.2f);
+            }
+        }
+        automate(instances, random);
+        
+        counters.start();
+        auto start = juce::Time::getHighResolutionTicks();
+        graph->processBlock(buffer, midi);
+        auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        auto counts = counters.stop();
+        
+        if (b >= warmupBlocks) {
+            blockTimes.push_back(elapsed);
+            for (size_t i = 0; i < totals.size(); ++i) {
+                totals[i] += counts[i];
+            }
+        }
+    }
+    
+    graph->releaseResources();
+    graph.reset();
+    
+    double blockDuration = double(blockSize) / sampleRate;
+    double mean = std::accumulate(blockTimes.begin(), blockTimes.end(), 0.0) / double(blockTimes.size());
+    
+    auto* result = new juce::DynamicObject();
+    result->setProperty("topology", topology);
+    result->setProperty("instances", n);
+    result->setProperty("sampleRate", sampleRate);
+    result->setProperty("blockSize", blockSize);
+    result->setProperty("meanBlockUs", mean * 1e6);
+    result->setProperty("p99BlockUs", percentile(blockTimes, 0.99) * 1e6);
+    result->setProperty("maxBlockUs", percentile(blockTimes, 1.0) * 1e6);
+    result->setProperty("load", mean / blockDuration);
+    result->setProperty("nsPerInstanceSample", mean * 1e9 / (double(n) * double(blockSize)));
+    result->setProperty("heapBytesPerInstance", double(heap.bytes) / double(n));
+    result->setProperty("residentBytesPerInstance", double(rssAfter - rssBefore) / double(n));
+    
+    if (counters.isAvailable()) {
+        double blocks = double(blockTimes.size());
+        result->setProperty("cyclesPerBlock", double(totals[PerfCounters::cycles]) / blocks);
+        result->setProperty("instructionsPerBlock", double(totals[PerfCounters::instructions]) / blocks);
+        result->setProperty("cacheReferencesPerBlock", double(totals[PerfCounters::cacheReferences]) / blocks);
+        result->setProperty("cacheMissesPerBlock", double(totals[PerfCounters::cacheMisses]) / blocks);
+    }
+    return result;
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+    
+    std::vector<int> counts { 1, 10, 50, 100, 200, 500 };
+    if (args.containsOption("--instances")) {
+        counts.clear();
+        for (auto& token : juce::StringArray::fromTokens(args.getValueForOption("--instances"), ",", "")) {
+            counts.push_back(juce::jlimit(1, 500, token.getIntValue()));
+        }
+    }
+    
+    auto topologies = juce::StringArray::fromTokens(args.containsOption("--topologies")
+                                                    ? args.getValueForOption("--topologies")
+                                                    : juce::String("series,parallel,mixed"), ",", "");
+    
+    double sampleRate = args.containsOption("--sample-rate") ? args.getValueForOption("--sample-rate").getDoubleValue() : 48000.0;
+    int blockSize = args.containsOption("--block-size") ? args.getValueForOption("--block-size").getIntValue() : 256;
+    double seconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 5.0;
+    
+    if (!PerfCounters().isAvailable()) {
+        std::cerr << "Hardware counters are not available, only timing and memory are reported" << std::endl;
+    }
+    
+    juce::Array<juce::var> results;
+    for (auto& topology : topologies) {
+        for (int n : counts) {
+            std::cerr << topology << ", " << n << " instances" << std::endl;
+            results.add(run(topology, n, sampleRate, blockSize, seconds));
+        }
+    }
+    
+    auto* report = new juce::DynamicObject();
+    report->setProperty("plugin", JucePlugin_Name);
+    report->setProperty("results", results);
+    auto json = juce::JSON::toString(juce::var(report));
+    
+    if (args.containsOption("--output")) {
+        if (!args.getFileForOption("--output").replaceWithText(json)) {
+            std::cerr << "Could not write the report" << std::endl;
+            return 1;
+        }
+    } else {
+        std::cout << json << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+    PerfCounters.h
+    Created: 28 Oct 2026 2:05:17pm
+    Author:  Edmund í Garði
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#if JUCE_LINUX
+ #include <linux/perf_event.h>
+ #include <sys/ioctl.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+#endif
+
+//==============================================================================
+/*
+    Hardware counters for the calling thread, through perf_event_open. On
+    other systems, or when the kernel doesn't allow it (see
+    /proc/sys/kernel/perf_event_paranoid), isAvailable() is false and every
+    count reads as zero.
+*/
+class PerfCounters
+{
+public:
+    enum Counter { cycles, instructions, cacheReferences, cacheMisses, numCounters };
+    
+    PerfCounters()
+    {
+       #if JUCE_LINUX
+        const std::array<std::uint64_t, numCounters> configs {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_REFERENCES,
+            PERF_COUNT_HW_CACHE_MISSES,
+        };
+        
+        for (size_t i = 0; i < configs.size(); ++i) {
+            perf_event_attr attr {};
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = configs[i];
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fds[i] = int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+       #endif
+    }
+    
+    ~PerfCounters()
+    {
+       #if JUCE_LINUX
+        for (int fd : fds) {
+            if (fd >= 0) { close(fd); }
+        }
+       #endif
+    }
+    
+    bool isAvailable() const noexcept
+    {
+        return std::all_of(fds.begin(), fds.end(), [](int fd) { return fd >= 0; });
+    }
+    
+    void start() noexcept
+    {
+       #if JUCE_LINUX
+        for (int fd : fds) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+       #endif
+    }
+    
+    // Stops counting and returns the counts since start()
+    std::array<std::uint64_t, numCounters> stop() noexcept
+    {
+        std::array<std::uint64_t, numCounters> counts {};
+       #if JUCE_LINUX
+        for (size_t i = 0; i < fds.size(); ++i) {
+            if (fds[i] >= 0) {
+                ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+                if (read(fds[i], &counts[i], sizeof(counts[i])) != sizeof(counts[i])) {
+                    counts[i] = 0;
+                }
+            }
+        }
+       #endif
+        return counts;
+    }
+    
+private:
+    std::array<int, numCounters> fds { -1, -1, -1, -1 };
+    
+    JUCE_DECLARE_NON_COPYABLE(PerfCounters)
+};
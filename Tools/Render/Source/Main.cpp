@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 26 Oct 2026 9:31:58am
+    Author:  Edmund í Garði
+
+    Offline file renderer. Streams a WAV, AIFF or FLAC file through the
+    processor and writes the result, echo tail included.
+
+        Render input.wav output.wav [--preset name|index] [--state file]
+               [--bits 24] [--block-size 4096]
+               [--tail-threshold -90] [--max-tail 30]
+
+    --state takes a blob saved from getStateInformation and is applied after
+    --preset. Reading and writing run on their own threads with buffers in
+    between, so the disk and the DSP overlap.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Common/FileRenderer.h"
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+    
+    if (args.size() < 2 || args[0].isOption() || args[1].isOption()) {
+        std::cerr << "Usage: Render input output [--preset name|index] [--state file] [--bits 24] "
+                     "[--block-size 4096] [--tail-threshold -90] [--max-tail 30]" << std::endl;
+        return 2;
+    }
+    
+    auto inputFile = args[0].resolveAsFile();
+    auto outputFile = args[1].resolveAsFile();
+    
+    FileRenderer::Settings settings;
+    if (args.containsOption("--bits")) {
+        settings.bits = args.getValueForOption("--bits").getIntValue();
+    }
+    if (args.containsOption("--block-size")) {
+        settings.blockSize = args.getValueForOption("--block-size").getIntValue();
+    }
+    if (args.containsOption("--tail-threshold")) {
+        settings.tailThreshold = juce::Decibels::decibelsToGain(args.getValueForOption("--tail-threshold").getFloatValue());
+    }
+    if (args.containsOption("--max-tail")) {
+        settings.maxTail = args.getValueForOption("--max-tail").getDoubleValue();
+    }
+    
+    // One thread reads ahead, another drains the writer
+    juce::TimeSliceThread readThread("Render reader");
+    juce::TimeSliceThread writeThread("Render writer");
+    readThread.startThread();
+    writeThread.startThread();
+    
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+    
+    DddelayyyAudioProcessor processor;
+    
+    auto stateFile = args.containsOption("--state") ? args.getFileForOption("--state") : juce::File();
+    auto error = FileRenderer::applySettings(processor, args.getValueForOption("--preset"), stateFile);
+    if (error.isNotEmpty()) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    
+    auto result = FileRenderer::render(processor, formats, inputFile, outputFile, settings, readThread, writeThread);
+    processor.releaseResources();
+    
+    if (!result.ok) {
+        std::cerr << result.error << std::endl;
+        return 1;
+    }
+    if (result.tailCut) {
+        std::cerr << "The tail was cut off after " << settings.maxTail << " s" << std::endl;
+    }
+    
+    std::cout << inputFile.getFileName() << ": " << juce::String(result.audioSeconds, 2) << " s rendered in "
+              << juce::String(result.wallSeconds, 2) << " s, "
+              << juce::String(result.audioSeconds / result.wallSeconds, 1) << "x realtime" << std::endl;
+    return 0;
+}
@@ -0,0 +1,444 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 24 Oct 2026 11:20:36am
+    Author:  Edmund í Garði
+
+    Golden-render null test. Renders fixed input through the processor under
+    scripted automation and compares the result with stored renders.
+
+        RenderTest [--golden dir] [--update] [--tolerance -120]
+                   [--offline-tolerance -30] [--input file.wav]
+                   [--output dir] [--scenario name,...]
+
+    The goldens live in Tools/RenderTest/Golden, which is found by walking
+    up from the executable, so the test runs from any build folder without
+    --golden. --update writes new golden renders instead of comparing; only
+    run it on a build whose sound has been checked, and commit the result.
+    The tolerance is the largest allowed deviation in dBFS. Failing renders
+    are written to --output so they can be inspected next to the goldens.
+    
+    Each scenario is also rendered offline, where the processor switches to
+    its high quality kernels, once from the start and once switching half
+    way through. Those renders can't null with the realtime one, since the
+    interpolation and the oversampling filters differ, so they are compared
+    by the energy of the difference relative to the realtime render, in dB.
+    Everything else is shared, so the difference stays far below -30 dB.
+    
+    Every processBlock call runs under RealtimeChecker. An allocation, lock
+    or blocking system call inside it fails the scenario and prints a stack
+    trace, so this also guards the audio thread on CI.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Common/Harness.h"
+#include "../../Common/RealtimeChecker.h"
+
+//==============================================================================
+static constexpr double sampleRate = 48000.0;
+static constexpr int blockSize = 512;
+static constexpr double bpm = 100.0;
+
+struct AutomationEvent
+{
+    double time;
+    juce::ParameterID id;
+    float value;
+    int program = -1;       // a program change instead of a parameter
+};
+
+struct Scenario
+{
+    juce::String name;
+    double length;
+    std::vector<AutomationEvent> events;
+};
+
+static std::vector<Scenario> allScenarios()
+{
+    std::vector<Scenario> scenarios;
+    
+    scenarios.push_back({ "delayJumps", 4.0, {
+        { 0.0, feedbackParamID, 50.0f },
+        { 0.0, delayTimeParamID, 100.0f },
+        { 0.8, delayTimeParamID, 450.0f },
+        { 1.6, delayTimeParamID, 20.0f },
+        { 2.4, delayTimeParamID, 1200.0f },
+        { 3.2, delayTimeParamID, 5.0f },
+    } });
+    
+    scenarios.push_back({ "tempoSync", 4.0, {
+        { 0.0, feedbackParamID, 40.0f },
+        { 0.0, delayTimeParamID, 300.0f },
+        { 0.8, tempoSyncParamID, 1.0f },
+        { 1.6, delayNoteParamID, 6.0f },
+        { 2.4, tempoSyncParamID, 0.0f },
+        { 3.2, tempoSyncParamID, 1.0f },
+    } });
+    
+    scenarios.push_back({ "bypass", 3.0, {
+        { 0.0, feedbackParamID, 60.0f },
+        { 0.7, bypassParamID, 1.0f },
+        { 1.4, bypassParamID, 0.0f },
+        { 2.1, bypassParamID, 1.0f },
+    } });
+    
+    // Feedback from fully inverted to fully positive in block-sized steps
+    Scenario sweep { "feedbackSweep", 4.0, { { 0.0, delayTimeParamID, 150.0f } } };
+    for (double t = 0.0; t < 4.0; t += double(blockSize) / sampleRate) {
+        sweep.events.push_back({ t, feedbackParamID, float(-100.0 + 200.0 * t / 4.0) });
+    }
+    scenarios.push_back(sweep);
+    
+    // Drive raises the loop gain, so the feedback stays low enough for the
+    // repeats to die away instead of running into the limiter
+    scenarios.push_back({ "colour", 4.0, {
+        { 0.0, feedbackParamID, 35.0f },
+        { 0.0, driveParamID, 60.0f },
+        { 0.0, diffuseParamID, 70.0f },
+        { 0.0, lowCutParamID, 200.0f },
+        { 0.0, highCutParamID, 4000.0f },
+        { 0.0, stereoParamID, 80.0f },
+        { 2.0, oversamplingParamID, 1.0f },
+        { 3.0, mixParamID, 30.0f },
+        { 3.0, gainParamID, -6.0f },
+    } });
+    
+    // The preset is stored into the parameters inside processBlock, so this
+    // runs that path under the realtime checker. The indices are into the
+    // factory bank, a user bank file changes the result.
+    scenarios.push_back({ "programChange", 4.0, {
+        { 0.0, feedbackParamID, 50.0f },
+        { 0.0, delayTimeParamID, 300.0f },
+        { 1.0, {}, 0.0f, 3 },   // Tape Echo
+        { 2.5, {}, 0.0f, 4 },   // Dub Space, tempo synced
+    } });
+    
+    return scenarios;
+}
+
+//==============================================================================
+// Clicks, noise bursts and a quiet sine, fixed by a seed so the input is
+// the same on every machine without storing it in the repository
+static juce::AudioBuffer<float> makeInput(double length)
+{
+    int numSamples = int(length * sampleRate);
+    juce::AudioBuffer<float> input(2, numSamples);
+    juce::Random random(20261024);
+    
+    for (int i = 0; i < numSamples; ++i) {
+        float sine = 0.1f * std::sin(juce::MathConstants<float>::twoPi * 330.0f * float(i) / float(sampleRate));
+        int phase = i % int(sampleRate / 2.0);
+        float click = phase == 0 ? 0.8f : 0.0f;
+        bool burst = phase > 4800 && phase < 7200;
+        
+        for (int ch = 0; ch < 2; ++ch) {
+            float noise = burst ? (random.nextFloat() - 0.5f) * 0.5f : 0.0f;
+            input.setSample(ch, i, sine + click + noise);
+        }
+    }
+    return input;
+}
+
+// Program changes come from the host's thread, like parameter changes, and
+// land in a later processBlock
+static void applyEvent(DddelayyyAudioProcessor& processor, const AutomationEvent& event)
+{
+    if (event.program >= 0) {
+        processor.setCurrentProgram(event.program);
+    } else {
+        Harness::setParameter(processor, event.id, event.value);
+    }
+}
+
+enum class RenderMode
+{
+    realtime,
+    offline,
+    switchingToOffline,     // half way through, like a host starting a bounce
+};
+
+static juce::AudioBuffer<float> render(const Scenario& scenario, const juce::AudioBuffer<float>& input,
+                                       RenderMode mode = RenderMode::realtime)
+{
+    DddelayyyAudioProcessor processor;
+    processor.setNonRealtime(mode == RenderMode::offline);
+    Harness::FixedPlayHead playHead(bpm);
+    processor.setPlayHead(&playHead);
+    
+    // Events at time zero are the starting state, set before prepareToPlay
+    // so the smoothers start there instead of gliding
+    size_t nextEvent = 0;
+    while (nextEvent < scenario.events.size() && scenario.events[nextEvent].time <= 0.0) {
+        applyEvent(processor, scenario.events[nextEvent++]);
+    }
+    
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+    
+    int numSamples = input.getNumSamples();
+    juce::AudioBuffer<float> output(2, numSamples);
+    juce::AudioBuffer<float> block(2, blockSize);
+    juce::MidiBuffer midi;
+    
+    for (int start = 0; start < numSamples; start += blockSize) {
+        int count = std::min(blockSize, numSamples - start);
+        double time = double(start) / sampleRate;
+        
+        // Automation lands on block boundaries, like most hosts
+        while (nextEvent < scenario.events.size() && scenario.events[nextEvent].time <= time) {
+            applyEvent(processor, scenario.events[nextEvent++]);
+        }
+        
+        if (mode == RenderMode::switchingToOffline && !processor.isNonRealtime() && start >= numSamples / 2) {
+            processor.setNonRealtime(true);
+        }
+        
+        block.setSize(2, count, false, false, true);
+        for (int ch = 0; ch < 2; ++ch) {
+            block.copyFrom(ch, 0, input, ch, start, count);
+        }
+        
+        {
+            RealtimeChecker::ScopedRealtime realtime;
+            processor.processBlock(block, midi);
+        }
+        
+        for (int ch = 0; ch < 2; ++ch) {
+            output.copyFrom(ch, start, block, ch, 0, count);
+        }
+    }
+    
+    processor.releaseResources();
+    processor.setPlayHead(nullptr);
+    return output;
+}
+
+//==============================================================================
+static bool writeWav(const juce::File& file, const juce::AudioBuffer<float>& buffer)
+{
+    file.deleteFile();
+    auto stream = file.createOutputStream();
+    if (stream == nullptr) { return false; }
+    
+    juce::WavAudioFormat format;
+    std::unique_ptr<juce::AudioFormatWriter> writer(format.createWriterFor(stream.get(), sampleRate, juce::uint32(buffer.getNumChannels()), 32, {}, 0));
+    if (writer == nullptr) { return false; }
+    stream.release();
+    
+    return writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+}
+
+static bool readWav(juce::AudioFormatManager& formats, const juce::File& file, juce::AudioBuffer<float>& buffer)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(file));
+    if (reader == nullptr) { return false; }
+    
+    buffer.setSize(int(reader->numChannels), int(reader->lengthInSamples));
+    return reader->read(&buffer, 0, buffer.getNumSamples(), 0, true, true);
+}
+
+struct Deviation
+{
+    float maximum = 0.0f;
+    int channel = 0;
+    int sample = 0;
+};
+
+static Deviation compare(const juce::AudioBuffer<float>& rendered, const juce::AudioBuffer<float>& golden)
+{
+    Deviation deviation;
+    for (int ch = 0; ch < rendered.getNumChannels(); ++ch) {
+        for (int i = 0; i < rendered.getNumSamples(); ++i) {
+            float difference = std::abs(rendered.getSample(ch, i) - golden.getSample(ch, i));
+            
+            // A nan anywhere is as far off as it gets
+            if (!(difference <= deviation.maximum)) {
+                deviation.maximum = std::isfinite(difference) ? difference : std::numeric_limits<float>::infinity();
+                deviation.channel = ch;
+                deviation.sample = i;
+            }
+        }
+    }
+    return deviation;
+}
+
+// Energy of the difference relative to the reference, in dB
+static float residual(const juce::AudioBuffer<float>& rendered, const juce::AudioBuffer<float>& reference)
+{
+    double difference = 0.0;
+    double energy = 0.0;
+    for (int ch = 0; ch < rendered.getNumChannels(); ++ch) {
+        for (int i = 0; i < rendered.getNumSamples(); ++i) {
+            double a = rendered.getSample(ch, i);
+            double b = reference.getSample(ch, i);
+            difference += (a - b) * (a - b);
+            energy += b * b;
+        }
+    }
+    
+    // A nan fails the comparison below
+    if (!std::isfinite(difference)) { return std::numeric_limits<float>::infinity(); }
+    if (energy == 0.0) { return difference == 0.0 ? -1000.0f : 0.0f; }
+    return float(10.0 * std::log10(std::max(difference / energy, 1.0e-100)));
+}
+
+// The Golden folder next to RenderTest.jucer, searched for upwards from the
+// executable in Builds
+static juce::File findGoldenDir()
+{
+    auto dir = juce::File::getSpecialLocation(juce::File::currentExecutableFile).getParentDirectory();
+    while (!dir.isRoot()) {
+        if (dir.getChildFile("RenderTest.jucer").existsAsFile()) {
+            return dir.getChildFile("Golden");
+        }
+        dir = dir.getParentDirectory();
+    }
+    return juce::File::getCurrentWorkingDirectory().getChildFile("Golden");
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+    
+    auto goldenDir = args.containsOption("--golden") ? args.getFileForOption("--golden") : findGoldenDir();
+    bool update = args.containsOption("--update");
+    
+    float toleranceDb = -120.0f;
+    if (args.containsOption("--tolerance")) {
+        toleranceDb = args.getValueForOption("--tolerance").getFloatValue();
+    }
+    float tolerance = juce::Decibels::decibelsToGain(toleranceDb, -1000.0f);
+    
+    float offlineTolerance = -30.0f;
+    if (args.containsOption("--offline-tolerance")) {
+        offlineTolerance = args.getValueForOption("--offline-tolerance").getFloatValue();
+    }
+    
+    juce::File outputDir;
+    if (args.containsOption("--output")) {
+        outputDir = args.getFileForOption("--output");
+        outputDir.createDirectory();
+    }
+    
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+    
+    juce::AudioBuffer<float> fileInput;
+    if (args.containsOption("--input") && !readWav(formats, args.getFileForOption("--input"), fileInput)) {
+        std::cerr << "Could not read the input file" << std::endl;
+        return 2;
+    }
+    
+    auto selected = juce::StringArray::fromTokens(args.getValueForOption("--scenario"), ",", "");
+    
+    if (update) {
+        goldenDir.createDirectory();
+    }
+    
+    int failures = 0;
+    
+    if (!RealtimeChecker::isAvailable()) {
+        std::cout << "The realtime checker is not available on this system, processBlock is not checked" << std::endl;
+    }
+    
+    for (auto& scenario : allScenarios()) {
+        if (!selected.isEmpty() && !selected.contains(scenario.name)) { continue; }
+        
+        juce::AudioBuffer<float> input;
+        if (fileInput.getNumSamples() > 0) {
+            // Stereo regardless of the file, mono files go to both sides
+            input.setSize(2, fileInput.getNumSamples());
+            for (int ch = 0; ch < 2; ++ch) {
+                input.copyFrom(ch, 0, fileInput, std::min(ch, fileInput.getNumChannels() - 1), 0, fileInput.getNumSamples());
+            }
+        } else {
+            input = makeInput(scenario.length);
+        }
+        
+        RealtimeChecker::reset();
+        auto rendered = render(scenario, input);
+        
+        if (auto violations = RealtimeChecker::getNumViolations(); violations > 0) {
+            std::cout << "FAIL   " << scenario.name << ": " << violations
+                      << " realtime violation(s) in processBlock, see the stack traces above" << std::endl;
+            failures += 1;
+            continue;
+        }
+        
+        if (!update) {
+            for (auto mode : { RenderMode::offline, RenderMode::switchingToOffline }) {
+                juce::String name = scenario.name + (mode == RenderMode::offline ? "-offline" : "-switching");
+                
+                RealtimeChecker::reset();
+                auto offline = render(scenario, input, mode);
+                
+                if (auto violations = RealtimeChecker::getNumViolations(); violations > 0) {
+                    std::cout << "FAIL   " << name << ": " << violations
+                              << " realtime violation(s) in processBlock, see the stack traces above" << std::endl;
+                    failures += 1;
+                    continue;
+                }
+                
+                float difference = residual(offline, rendered);
+                bool ok = difference <= offlineTolerance;
+                
+                std::cout << (ok ? "ok     " : "FAIL   ") << name
+                          << ": residual " << juce::String(difference, 1) << " dB against the realtime render" << std::endl;
+                
+                if (!ok) {
+                    failures += 1;
+                    if (outputDir.isDirectory()) {
+                        writeWav(outputDir.getChildFile(name + ".wav"), offline);
+                    }
+                }
+            }
+        }
+        
+        auto goldenFile = goldenDir.getChildFile(scenario.name + ".wav");
+        
+        if (update) {
+            bool ok = writeWav(goldenFile, rendered);
+            std::cout << (ok ? "wrote  " : "FAILED ") << goldenFile.getFullPathName() << std::endl;
+            failures += ok ? 0 : 1;
+            continue;
+        }
+        
+        juce::AudioBuffer<float> golden;
+        if (!readWav(formats, goldenFile, golden)) {
+            std::cout << "FAIL   " << scenario.name << ": no golden render at " << goldenFile.getFullPathName() << std::endl;
+            failures += 1;
+            continue;
+        }
+        
+        if (golden.getNumChannels() != rendered.getNumChannels() || golden.getNumSamples() != rendered.getNumSamples()) {
+            std::cout << "FAIL   " << scenario.name << ": golden render has a different length or channel count" << std::endl;
+            failures += 1;
+            continue;
+        }
+        
+        auto deviation = compare(rendered, golden);
+        bool ok = deviation.maximum <= tolerance;
+        
+        std::cout << (ok ? "ok     " : "FAIL   ") << scenario.name
+                  << ": max deviation " << juce::String(juce::Decibels::gainToDecibels(deviation.maximum, -1000.0f), 1) << " dBFS"
+                  << " on channel " << deviation.channel
+                  << " at sample " << deviation.sample
+                  << " (" << juce::String(double(deviation.sample) / sampleRate, 4) << " s)" << std::endl;
+        
+        if (!ok) {
+            failures += 1;
+            if (outputDir.isDirectory()) {
+                writeWav(outputDir.getChildFile(scenario.name + ".wav"), rendered);
+            }
+        }
+    }
+    
+    std::cout << failures << " failure(s)" << std::endl;
+    return failures == 0 ? 0 : 1;
+}